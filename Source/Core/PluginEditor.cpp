@@ -452,6 +452,7 @@ PluginEditor::PluginEditor(PluginProcessor& p)
     // Build flat preset list for prev/next navigation
     auto& sampleManager = processor.getSamplePresetManager();
     const auto& categories = sampleManager.getCategories();
+    lastLibraryVersion = sampleManager.getLibraryVersion();
     for (const auto& cat : categories)
     {
         auto presets = sampleManager.getPresetsInCategory(cat);
@@ -642,6 +643,17 @@ void PluginEditor::timerCallback()
     // RMS meter always updates (animated)
     topBar.setRmsLevel(processor.getRmsLevel());
 
+    // Zones decoded so far while a sample preset loads
+    topBar.setLoadProgress(processor.getSampleSynth().getLoadProgress());
+
+    // Sample folders changed on disk (background rescan or folder watcher)
+    auto libraryVersion = processor.getSamplePresetManager().getLibraryVersion();
+    if (libraryVersion != lastLibraryVersion)
+    {
+        lastLibraryVersion = libraryVersion;
+        refreshSampleLibrary();
+    }
+
     // Only repaint components when their values actually change
     float unisonVoices = apvts.getRawParameterValue("unison_voices")->load();
     if (unisonVoices != lastUnisonVoices)
@@ -1034,6 +1046,39 @@ void PluginEditor::updatePresetBrowserCategories()
         updatePresetBrowserPresets(categories[0]);
 }
 
+void PluginEditor::refreshSampleLibrary()
+{
+    auto& sampleManager = processor.getSamplePresetManager();
+    const auto& categories = sampleManager.getCategories();
+
+    allPresetsFlat.clear();
+    for (const auto& cat : categories)
+    {
+        auto presets = sampleManager.getPresetsInCategory(cat);
+        for (const auto& preset : presets)
+            allPresetsFlat.push_back({cat, preset.name});
+    }
+
+    // Keep prev/next stepping from the loaded preset
+    const auto current = processor.getCurrentSamplePresetName();
+    for (size_t i = 0; i < allPresetsFlat.size(); ++i)
+    {
+        if (allPresetsFlat[i].second == current)
+        {
+            currentPresetIndex = static_cast<int>(i);
+            break;
+        }
+    }
+
+    loadPresetList();
+
+    if (presetBrowserVisible)
+    {
+        presetBrowser.refreshCategories(categories);
+        updatePresetBrowserPresets(presetBrowser.getCurrentCategory());
+    }
+}
+
 void PluginEditor::updatePresetBrowserPresets(const juce::String& category)
 {
     auto& sampleManager = processor.getSamplePresetManager();
@@ -480,6 +480,7 @@ private:
     void hidePresetBrowser();
     void updatePresetBrowserCategories();
     void updatePresetBrowserPresets(const juce::String& category);
+    void refreshSampleLibrary();
     void selectNextPreset();
     void selectPrevPreset();
     int currentPresetIndex = 0;
@@ -556,6 +557,7 @@ private:
     bool lastReverbEnabled = false, lastDelayEnabled = false, lastChorusEnabled = false;
     bool lastGlideAlways = false;
     bool lastLfo1Sync = false, lastLfo2Sync = false;
+    juce::uint32 lastLibraryVersion = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginEditor)
 };
@@ -14,7 +14,15 @@ PluginProcessor::PluginProcessor()
     // Create a fake resource dir with Samples subfolder for the manager
     juce::File resourceDir = samplesDir.getParentDirectory();
 
-    samplePresetManager.scanSampleDirectory(resourceDir);
+    // A preset restored before the rescan knew its folder loads once the rescan lands
+    samplePresetManager.onRescanFinished = [this]
+    {
+        if (pendingSamplePresetName.isNotEmpty())
+            loadSamplePreset(std::exchange(pendingSamplePresetName, {}));
+    };
+
+    // Starts from the cached index; changed folders are rescanned in the background
+    samplePresetManager.loadIndex(getConfigDirectory().getChildFile("SampleIndex.bin"), resourceDir);
 
     // Debug: log what we found
     DBG("=== Sample Preset Manager Initialized ===");
@@ -106,6 +114,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         juce::ParameterID{"noise_level", 1}, "Noise Level",
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"noise_type", 1}, "Noise Type",
+        juce::StringArray{"White", "Pink", "Brown"}, 0));
+
     // ===== Filter =====
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{"filter_type", 1}, "Filter Type",
@@ -241,6 +253,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         juce::ParameterID{"voice_mode", 1}, "Voice Mode",
         juce::StringArray{"Poly", "Mono", "Legato"}, 0));
 
+    // Per-voice oversampling of oscillators + filter
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"oversampling", 1}, "Oversampling",
+        juce::StringArray{"1x", "2x", "4x"}, 0));
+
     // ===== FX =====
     // Reverb
     params.push_back(std::make_unique<juce::AudioParameterBool>(
@@ -255,6 +272,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         juce::ParameterID{"reverb_damping", 1}, "Reverb Damping",
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
 
+    // Convolution
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"conv_enabled", 1}, "Convolution Enabled", false));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"conv_mix", 1}, "Convolution Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f), 0.3f));
+
     // Delay
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID{"delay_enabled", 1}, "Delay Enabled", false));
@@ -267,6 +291,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"delay_feedback", 1}, "Delay Feedback",
         juce::NormalisableRange<float>(0.0f, 0.99f), 0.5f));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"delay_sync", 1}, "Delay Sync", false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"delay_division", 1}, "Delay Division",
+        juce::StringArray{"1/16", "1/8", "1/8D", "1/4", "1/4D", "1/2", "1 Bar"}, 3));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"delay_taps", 1}, "Delay Taps",
+        juce::StringArray{"1", "2", "3", "4"}, 0));
 
     // Chorus
     params.push_back(std::make_unique<juce::AudioParameterBool>(
@@ -280,6 +312,9 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"chorus_depth", 1}, "Chorus Depth",
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.25f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"chorus_mode", 1}, "Chorus Mode",
+        juce::StringArray{"Chorus", "Ensemble"}, 0));
 
     // Flanger
     params.push_back(std::make_unique<juce::AudioParameterBool>(
@@ -297,6 +332,19 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         juce::ParameterID{"flanger_feedback", 1}, "Flanger Feedback",
         juce::NormalisableRange<float>(-0.95f, 0.95f), 0.5f));
 
+    // Master limiter (end of the FX rack)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"limiter_enabled", 1}, "Limiter Enabled", false));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"limiter_ceiling", 1}, "Limiter Ceiling",
+        juce::NormalisableRange<float>(-12.0f, 0.0f), -1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"limiter_lookahead", 1}, "Limiter Lookahead",
+        juce::NormalisableRange<float>(0.5f, 10.0f), 5.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"limiter_release", 1}, "Limiter Release",
+        juce::NormalisableRange<float>(10.0f, 1000.0f, 0.0f, 0.4f), 100.0f));
+
     // ===== Macro Controls =====
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"macro_boost", 1}, "Macro Boost",
@@ -322,6 +370,8 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     voiceManager.prepare(sampleRate, samplesPerBlock);
     sampleSynth.prepare(sampleRate, samplesPerBlock);
     fxRack.prepare(sampleRate, samplesPerBlock);
+    updateLimiter();
+    setLatencySamples(fxRack.getLatencySamples());
     globalModMatrix.prepare(sampleRate, samplesPerBlock);
     globalLFO1.prepare(sampleRate);
     globalLFO2.prepare(sampleRate);
@@ -339,6 +389,15 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     scopeMonoBuffer.resize(static_cast<size_t>(samplesPerBlock));
 }
 
+void PluginProcessor::updateLimiter()
+{
+    auto& limiter = fxRack.get<DSP::LimiterEffect>();
+    limiter.setActive(apvts.getRawParameterValue("limiter_enabled")->load() > 0.5f);
+    limiter.setCeiling(apvts.getRawParameterValue("limiter_ceiling")->load());
+    limiter.setLookahead(apvts.getRawParameterValue("limiter_lookahead")->load());
+    limiter.setRelease(apvts.getRawParameterValue("limiter_release")->load());
+}
+
 void PluginProcessor::releaseResources()
 {
     voiceManager.reset();
@@ -359,6 +418,15 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // Offline renders must not start with the previous (or no) instrument,
+    // nor play a neighbouring zone while a lazily loaded one is fetched
+    if (isNonRealtime())
+    {
+        if (sampleSynth.isLoadPending())
+            sampleSynth.waitForPendingLoad(10000);
+        sampleSynth.waitForAllZones(10000);
+    }
+
     // Get tempo from host and sync to sample player
     bool gotBPMFromHost = false;
     if (auto* playHead = getPlayHead())
@@ -410,6 +478,8 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     voiceParams.osc2Pan = apvts.getRawParameterValue("osc2_pan")->load();
 
     voiceParams.noiseLevel = apvts.getRawParameterValue("noise_level")->load();
+    voiceParams.noiseColour = static_cast<DSP::NoiseGenerator::Colour>(
+        static_cast<int>(apvts.getRawParameterValue("noise_type")->load()));
 
     voiceParams.filterType = static_cast<DSP::SVFFilter::Type>(
         static_cast<int>(apvts.getRawParameterValue("filter_type")->load()));
@@ -438,6 +508,8 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     voiceParams.glideTime = apvts.getRawParameterValue("glide_time")->load();
     voiceParams.glideAlways = apvts.getRawParameterValue("glide_always")->load() > 0.5f;
 
+    voiceParams.oversampling = 1 << static_cast<int>(apvts.getRawParameterValue("oversampling")->load());
+
     // Use smoothed master level to avoid clicks
     smoothedMasterLevel.setTargetValue(apvts.getRawParameterValue("master_level")->load());
     voiceParams.masterLevel = smoothedMasterLevel.getNextValue();
@@ -462,6 +534,13 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
     voiceManager.setLFOParams(lfo1Wave, lfo1Rate, lfo2Wave, lfo2Rate);
 
+    // Macros as mod sources (voice routings; the FX ones are read in evaluateGlobalModulation)
+    using Modulation::ModSource;
+    voiceManager.setGlobalSourceValue(ModSource::Macro1, apvts.getRawParameterValue("macro_boost")->load() / 100.0f);
+    voiceManager.setGlobalSourceValue(ModSource::Macro2, apvts.getRawParameterValue("macro_air")->load() / 100.0f);
+    voiceManager.setGlobalSourceValue(ModSource::Macro3, apvts.getRawParameterValue("macro_body")->load() / 100.0f);
+    voiceManager.setGlobalSourceValue(ModSource::Macro4, apvts.getRawParameterValue("macro_warp")->load() / 100.0f);
+
     // Unison
     int unisonVoices = static_cast<int>(apvts.getRawParameterValue("unison_voices")->load());
     float unisonDetune = apvts.getRawParameterValue("unison_detune")->load();
@@ -480,7 +559,8 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     int pitchBendRange = static_cast<int>(apvts.getRawParameterValue("pitch_bend_range")->load());
     sampleSynth.setPitchBendRange(pitchBendRange);
 
-    // Process MIDI — handle MIDI learn CC mappings before voice processing
+    // Process MIDI learn CC mappings before voice processing.
+    // Voice events are applied by the voice manager at quantum boundaries.
     for (const auto metadata : midiMessages)
     {
         const auto& msg = metadata.getMessage();
@@ -489,12 +569,27 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
             midiLearn.processMidiCC(msg.getControllerNumber(),
                                     msg.getControllerValue() / 127.0f, apvts);
         }
-        voiceManager.handleMidiMessage(msg);
     }
 
     // Clear buffer once at the start
     buffer.clear();
 
+    // Sleep: no incoming events, no voices and every FX tail has rung out.
+    // The output stays silent until the next MIDI event wakes us up.
+    const bool voicesActive = voiceManager.getActiveVoiceCount() > 0 || sampleSynth.isAnyVoiceActive();
+    if (midiMessages.isEmpty() && !voicesActive && fxRack.isIdle())
+    {
+        if (!asleep)
+        {
+            asleep = true;
+            currentRmsLevel.store(0.0f, std::memory_order_relaxed);
+            scopeBuffer.fill(0.0f);
+            scopeReady.store(true, std::memory_order_release);
+        }
+        return;
+    }
+    asleep = false;
+
     // Update sample synth envelope parameters from APVTS
     Engine::SampleEnvelopeParams sampleEnvParams;
     sampleEnvParams.attack = apvts.getRawParameterValue("amp_attack")->load();
@@ -511,7 +606,7 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     sampleSynth.processBlock(buffer, midiMessages);
 
     // Process VA synth voices — mix into existing sample synth output
-    voiceManager.processBlock(buffer, false);
+    voiceManager.processBlock(buffer, midiMessages, false);
 
     // Master FX enable - controlled by Engine Start button (flanger_enabled parameter)
     bool engineStarted = apvts.getRawParameterValue("flanger_enabled")->load() > 0.5f;
@@ -524,22 +619,40 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         reverb->setEnabled(enabled);
         if (enabled)
         {
-            smoothedReverbMix.setTargetValue(apvts.getRawParameterValue("reverb_mix")->load());
-            reverb->setMix(smoothedReverbMix.getNextValue());
+            fxBase.reverbMix = apvts.getRawParameterValue("reverb_mix")->load();
             reverb->setRoomSize(apvts.getRawParameterValue("reverb_size")->load());
             reverb->setDamping(apvts.getRawParameterValue("reverb_damping")->load());
         }
     }
 
+    if (auto* convolution = fxRack.getEffect<DSP::ConvolutionEffect>())
+    {
+        bool enabled = engineStarted && apvts.getRawParameterValue("conv_enabled")->load() > 0.5f
+                       && convolution->hasImpulseResponse();
+        convolution->setEnabled(enabled);
+        if (enabled)
+            fxBase.convolutionMix = apvts.getRawParameterValue("conv_mix")->load();
+    }
+
     if (auto* delay = fxRack.getEffect<DSP::DelayEffect>())
     {
         bool enabled = engineStarted && apvts.getRawParameterValue("delay_enabled")->load() > 0.5f;
         delay->setEnabled(enabled);
         if (enabled)
         {
-            smoothedDelayMix.setTargetValue(apvts.getRawParameterValue("delay_mix")->load());
-            delay->setMix(smoothedDelayMix.getNextValue());
-            delay->setDelayTime(apvts.getRawParameterValue("delay_time")->load());
+            fxBase.delayMix = apvts.getRawParameterValue("delay_mix")->load();
+            if (apvts.getRawParameterValue("delay_sync")->load() > 0.5f)
+            {
+                // Beats per division, matching the delay_division choices
+                static constexpr float divisionBeats[] = { 0.25f, 0.5f, 0.75f, 1.0f, 1.5f, 2.0f, 4.0f };
+                int divisionIdx = static_cast<int>(apvts.getRawParameterValue("delay_division")->load());
+                delay->setDelayTimeSync(currentBPM, divisionBeats[juce::jlimit(0, 6, divisionIdx)]);
+            }
+            else
+            {
+                delay->setDelayTime(apvts.getRawParameterValue("delay_time")->load());
+            }
+            delay->setNumTaps(static_cast<int>(apvts.getRawParameterValue("delay_taps")->load()) + 1);
             delay->setFeedback(apvts.getRawParameterValue("delay_feedback")->load());
         }
     }
@@ -550,10 +663,12 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         chorus->setEnabled(enabled);
         if (enabled)
         {
-            smoothedChorusMix.setTargetValue(apvts.getRawParameterValue("chorus_mix")->load());
-            chorus->setMix(smoothedChorusMix.getNextValue());
-            chorus->setRate(apvts.getRawParameterValue("chorus_rate")->load());
+            fxBase.chorusMix = apvts.getRawParameterValue("chorus_mix")->load();
+            fxBase.chorusRate = apvts.getRawParameterValue("chorus_rate")->load();
             chorus->setDepth(apvts.getRawParameterValue("chorus_depth")->load());
+            chorus->setMode(apvts.getRawParameterValue("chorus_mode")->load() > 0.5f
+                                ? DSP::ChorusEffect::Mode::Ensemble
+                                : DSP::ChorusEffect::Mode::Chorus);
         }
     }
 
@@ -563,8 +678,7 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         flanger->setEnabled(engineStarted);
         if (engineStarted)
         {
-            smoothedFlangerMix.setTargetValue(apvts.getRawParameterValue("flanger_mix")->load());
-            flanger->setMix(smoothedFlangerMix.getNextValue());
+            fxBase.flangerMix = apvts.getRawParameterValue("flanger_mix")->load();
             flanger->setRate(apvts.getRawParameterValue("flanger_rate")->load());
             flanger->setDepth(apvts.getRawParameterValue("flanger_depth")->load());
             flanger->setFeedback(apvts.getRawParameterValue("flanger_feedback")->load());
@@ -639,8 +753,45 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
     }
 
-    // Process FX (will be bypassed if all effects are disabled)
-    fxRack.process(buffer);
+    // Output protection is independent of Engine Start
+    updateLimiter();
+
+    // Process FX (will be bypassed if all effects are disabled). With no voices
+    // sounding, only effects that are still ringing out are run.
+    const bool engineInputSilent = !voicesActive && midiMessages.isEmpty();
+
+    // Global modulation runs at control rate: with any global routing active the
+    // chain is processed one quantum at a time, the matrix evaluated at the start
+    // of each and the results fed to the FX through smoothed ramps.
+    rebuildGlobalModMatrix();
+    globalLFO1.setWaveform(lfo1Wave);
+    globalLFO1.setRate(lfo1Rate);
+    globalLFO2.setWaveform(lfo2Wave);
+    globalLFO2.setRate(lfo2Rate);
+
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int quantum = globalModMatrix.getNumRoutings() > 0 ? GLOBAL_MOD_QUANTUM : numSamples;
+
+        for (int start = 0; start < numSamples; start += quantum)
+        {
+            const int n = std::min(quantum, numSamples - start);
+            evaluateGlobalModulation(midiMessages, start, n);
+            applyFXModulation(n);
+
+            juce::AudioBuffer<float> slice(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, n);
+            fxRack.process(slice, engineInputSilent);
+        }
+    }
+
+    // Lookahead changes (or toggling the limiter) change the plugin's latency
+    const int latency = fxRack.getLatencySamples();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    // Host tail: the longest release plus everything the FX chain can add
+    tailLengthSeconds.store(apvts.getRawParameterValue("amp_release")->load() + fxRack.getTailLengthSeconds(),
+                            std::memory_order_relaxed);
 
     // Compute RMS level for metering (max of L/R channels)
     {
@@ -686,6 +837,11 @@ static Modulation::ModSource srcIdToEnum(int id)
         case 5: return Modulation::ModSource::FilterEnv;
         case 6: return Modulation::ModSource::Velocity;
         case 7: return Modulation::ModSource::ModWheel;
+        case 8: return Modulation::ModSource::Aftertouch;
+        case 9: return Modulation::ModSource::Macro1;
+        case 10: return Modulation::ModSource::Macro2;
+        case 11: return Modulation::ModSource::Macro3;
+        case 12: return Modulation::ModSource::Macro4;
         default: return Modulation::ModSource::None;
     }
 }
@@ -701,16 +857,158 @@ static Modulation::ModDest dstIdToEnum(int id)
         case 5: return Modulation::ModDest::Osc1Level;
         case 6: return Modulation::ModDest::AmpPan;
         case 7: return Modulation::ModDest::AmpLevel;
+        case 8: return Modulation::ModDest::ReverbMix;
+        case 9: return Modulation::ModDest::DelayMix;
+        case 10: return Modulation::ModDest::DelayTime;
+        case 11: return Modulation::ModDest::ChorusMix;
+        case 12: return Modulation::ModDest::ChorusRate;
+        case 13: return Modulation::ModDest::FXMix;
         default: return Modulation::ModDest::None;
     }
 }
 
+// Sources with a single, plugin-wide value (no per-voice envelopes or velocity)
+static bool isGlobalSource(Modulation::ModSource src)
+{
+    switch (src)
+    {
+        case Modulation::ModSource::LFO1:
+        case Modulation::ModSource::LFO2:
+        case Modulation::ModSource::ModWheel:
+        case Modulation::ModSource::Aftertouch:
+        case Modulation::ModSource::Macro1:
+        case Modulation::ModSource::Macro2:
+        case Modulation::ModSource::Macro3:
+        case Modulation::ModSource::Macro4:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Destinations on the shared FX chain
+static bool isGlobalDest(Modulation::ModDest dst)
+{
+    switch (dst)
+    {
+        case Modulation::ModDest::FXMix:
+        case Modulation::ModDest::ReverbMix:
+        case Modulation::ModDest::DelayMix:
+        case Modulation::ModDest::DelayTime:
+        case Modulation::ModDest::ChorusMix:
+        case Modulation::ModDest::ChorusRate:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void PluginProcessor::rebuildGlobalModMatrix()
+{
+    if (!globalRowsDirty.load(std::memory_order_acquire))
+        return;
+
+    // Never wait on the message thread; try again next block if it holds the lock
+    const juce::SpinLock::ScopedTryLockType lock(globalRowsLock);
+    if (!lock.isLocked())
+        return;
+
+    globalModMatrix.clearRoutings();
+    globalModMatrix.reset();
+    for (const auto& r : pendingGlobalRows)
+    {
+        auto src = srcIdToEnum(r.srcId);
+        auto dst = dstIdToEnum(r.dstId);
+        if (isGlobalSource(src) && isGlobalDest(dst))
+            globalModMatrix.addRouting(src, dst, r.amount);
+    }
+    globalRowsDirty.store(false, std::memory_order_release);
+}
+
+void PluginProcessor::evaluateGlobalModulation(const juce::MidiBuffer& midi, int startSample, int numSamples)
+{
+    if (globalModMatrix.getNumRoutings() == 0)
+        return;
+
+    // Controller changes up to the end of this quantum
+    for (const auto metadata : midi)
+    {
+        if (metadata.samplePosition >= startSample + numSamples)
+            break;
+
+        const auto& msg = metadata.getMessage();
+        if (msg.isController() && msg.getControllerNumber() == 1)
+            globalModWheel = msg.getControllerValue() / 127.0f;
+        else if (msg.isChannelPressure())
+            globalAftertouch = msg.getChannelPressureValue() / 127.0f;
+        else if (msg.isAftertouch())
+            globalAftertouch = msg.getAfterTouchValue() / 127.0f;
+    }
+
+    using Modulation::ModSource;
+    globalModMatrix.setSourceValue(ModSource::LFO1, globalLFO1.advance(numSamples));
+    globalModMatrix.setSourceValue(ModSource::LFO2, globalLFO2.advance(numSamples));
+    globalModMatrix.setSourceValue(ModSource::ModWheel, globalModWheel);
+    globalModMatrix.setSourceValue(ModSource::Aftertouch, globalAftertouch);
+    globalModMatrix.setSourceValue(ModSource::Macro1, apvts.getRawParameterValue("macro_boost")->load() / 100.0f);
+    globalModMatrix.setSourceValue(ModSource::Macro2, apvts.getRawParameterValue("macro_air")->load() / 100.0f);
+    globalModMatrix.setSourceValue(ModSource::Macro3, apvts.getRawParameterValue("macro_body")->load() / 100.0f);
+    globalModMatrix.setSourceValue(ModSource::Macro4, apvts.getRawParameterValue("macro_warp")->load() / 100.0f);
+    globalModMatrix.process();
+}
+
+void PluginProcessor::applyFXModulation(int numSamples)
+{
+    using Modulation::ModDest;
+    const float fxMix = globalModMatrix.getDestinationValue(ModDest::FXMix);
+
+    auto rampedMix = [&](auto& smoother, float base, ModDest dest) {
+        smoother.setTargetValue(juce::jlimit(0.0f, 1.0f, base + fxMix + globalModMatrix.getDestinationValue(dest)));
+        return smoother.skip(numSamples);
+    };
+
+    auto& reverb = fxRack.get<DSP::ReverbEffect>();
+    if (reverb.isEnabled())
+        reverb.setMix(rampedMix(smoothedReverbMix, fxBase.reverbMix, ModDest::ReverbMix));
+
+    auto& delay = fxRack.get<DSP::DelayEffect>();
+    if (delay.isEnabled())
+    {
+        delay.setMix(rampedMix(smoothedDelayMix, fxBase.delayMix, ModDest::DelayMix));
+        // Delay time modulation is in octaves and glides inside the delay
+        delay.setDelayTimeModulation(globalModMatrix.getDestinationValue(ModDest::DelayTime));
+    }
+
+    auto& chorus = fxRack.get<DSP::ChorusEffect>();
+    if (chorus.isEnabled())
+    {
+        chorus.setMix(rampedMix(smoothedChorusMix, fxBase.chorusMix, ModDest::ChorusMix));
+        chorus.setRate(fxBase.chorusRate * std::exp2(globalModMatrix.getDestinationValue(ModDest::ChorusRate)));
+    }
+
+    // No dedicated destinations: FX Mix only
+    auto& flanger = fxRack.get<DSP::FlangerEffect>();
+    if (flanger.isEnabled())
+        flanger.setMix(rampedMix(smoothedFlangerMix, fxBase.flangerMix, ModDest::None));
+
+    auto& convolution = fxRack.get<DSP::ConvolutionEffect>();
+    if (convolution.isEnabled())
+        convolution.setMix(juce::jlimit(0.0f, 1.0f, fxBase.convolutionMix + fxMix));
+}
+
 void PluginProcessor::setModMatrixRow(int row, int srcId, int dstId, float amount)
 {
     if (row < 0 || row >= 5) return;
     modMatrixRows[static_cast<size_t>(row)] = { srcId, dstId, amount };
 
-    // Rebuild all voice mod matrices with the updated routings
+    // Stage the rows for the global (FX) matrix; the audio thread rebuilds it
+    {
+        const juce::SpinLock::ScopedLockType lock(globalRowsLock);
+        pendingGlobalRows = modMatrixRows;
+    }
+    globalRowsDirty.store(true, std::memory_order_release);
+
+    // Rebuild all voice mod matrices with the updated routings (FX destinations live in the global matrix)
     voiceManager.rebuildModMatrix([&](Engine::SynthVoice& voice) {
         auto& mm = voice.getModMatrix();
         mm.clearRoutings();
@@ -718,12 +1016,21 @@ void PluginProcessor::setModMatrixRow(int row, int srcId, int dstId, float amoun
         {
             auto src = srcIdToEnum(r.srcId);
             auto dst = dstIdToEnum(r.dstId);
-            if (src != Modulation::ModSource::None && dst != Modulation::ModDest::None)
+            if (src != Modulation::ModSource::None && dst != Modulation::ModDest::None && !isGlobalDest(dst))
                 mm.addRouting(src, dst, r.amount);
         }
     });
 }
 
+void PluginProcessor::loadConvolutionImpulse(const juce::File& file)
+{
+    if (auto* convolution = fxRack.getEffect<DSP::ConvolutionEffect>())
+    {
+        convolutionImpulseFile = file;
+        convolution->loadImpulseResponse(file);
+    }
+}
+
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     DBG("=== getStateInformation called ===");
@@ -733,9 +1040,25 @@ void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 
     auto state = apvts.copyState();
 
+    juce::String restoringName;
+    {
+        const juce::ScopedLock sl(restoringLock);
+        restoringName = restoringSamplePresetName;
+    }
+
     // Only save preset name if we have one OR if state was properly restored
     // This protects against FL Studio calling getState before setState
-    if (currentSamplePresetName.isNotEmpty() || stateHasBeenRestored)
+    if (restoringName.isNotEmpty())
+    {
+        // Restored off the message thread; the load hasn't run there yet
+        state.setProperty("samplePresetName", restoringName, nullptr);
+    }
+    else if (pendingSamplePresetName.isNotEmpty())
+    {
+        // Restored, but still waiting for the library rescan to find it
+        state.setProperty("samplePresetName", pendingSamplePresetName, nullptr);
+    }
+    else if (currentSamplePresetName.isNotEmpty() || stateHasBeenRestored)
     {
         state.setProperty("samplePresetName", currentSamplePresetName, nullptr);
     }
@@ -751,6 +1074,9 @@ void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
         }
     }
 
+    if (convolutionImpulseFile != juce::File())
+        state.setProperty("convolutionImpulse", convolutionImpulseFile.getFullPathName(), nullptr);
+
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
 
     // Save MIDI learn mappings
@@ -797,13 +1123,18 @@ void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
             if (savedPresetName.isNotEmpty())
             {
                 DBG("  Calling loadSamplePreset...");
-                loadSamplePreset(savedPresetName);
+                restoreSamplePreset(savedPresetName);
             }
             else
             {
                 DBG("  No preset name in state - skipping load");
             }
 
+            // Restore convolution IR (loads in the background)
+            juce::String savedImpulse = newState.getProperty("convolutionImpulse", "").toString();
+            if (savedImpulse.isNotEmpty())
+                loadConvolutionImpulse(juce::File(savedImpulse));
+
             // Restore MIDI learn mappings
             midiLearn.loadFromXml(*xml);
 
@@ -864,12 +1195,29 @@ void PluginProcessor::loadSamplePreset(const juce::String& presetName)
     DBG("  Preset name: " + presetName);
     DBG("  Current preset before: " + (currentSamplePresetName.isEmpty() ? "(empty)" : currentSamplePresetName));
 
+    pendingSamplePresetName.clear();
+
     const auto* preset = samplePresetManager.findPreset(presetName);
+    if (preset == nullptr && samplePresetManager.isRescanning())
+    {
+        // The name may belong to a folder added since the index was written
+        DBG("  Preset not in index yet - loading it when the library rescan finishes");
+        pendingSamplePresetName = presetName;
+        return;
+    }
+
     if (preset != nullptr)
     {
         bool success = false;
 
-        if (preset->isMultisampled && !preset->zones.empty())
+        // Loads run in the background and swap in at a block boundary;
+        // success here means the request was accepted
+        if (preset->bank != nullptr)
+        {
+            // Packed bank: zones resolve to pointers into the mapped file
+            success = sampleSynth.loadBankPreset(preset->bank, preset->bankPresetIndex);
+        }
+        else if (preset->isMultisampled && !preset->zones.empty())
         {
             // Load multisampled preset with all zones
             DBG("  Found multisampled preset with " + juce::String(preset->zones.size()) + " zones");
@@ -888,7 +1236,7 @@ void PluginProcessor::loadSamplePreset(const juce::String& presetName)
             success = sampleSynth.loadSample(preset->sampleFile);
         }
 
-        DBG("  Sample load " + juce::String(success ? "SUCCESS" : "FAILED"));
+        DBG("  Sample load " + juce::String(success ? "QUEUED" : "FAILED"));
 
         if (success)
         {
@@ -902,26 +1250,67 @@ void PluginProcessor::loadSamplePreset(const juce::String& presetName)
     }
 }
 
+void PluginProcessor::restoreSamplePreset(const juce::String& presetName)
+{
+    const bool onMessageThread = juce::MessageManager::existsAndIsCurrentThread();
+
+    // The preset library is rebuilt on the message thread, so the lookup runs there.
+    // Only the newest restore loads; one still queued is superseded.
+    {
+        const juce::ScopedLock sl(restoringLock);
+        restoringSamplePresetName = onMessageThread ? juce::String() : presetName;
+    }
+
+    if (onMessageThread)
+    {
+        loadSamplePreset(presetName);
+        return;
+    }
+
+    juce::MessageManager::callAsync([weakThis = juce::WeakReference<PluginProcessor>(this), presetName]
+    {
+        auto* processor = weakThis.get();
+        if (processor == nullptr)
+            return;
+
+        {
+            const juce::ScopedLock sl(processor->restoringLock);
+            if (processor->restoringSamplePresetName != presetName)
+                return;
+        }
+
+        processor->loadSamplePreset(presetName);
+
+        const juce::ScopedLock sl(processor->restoringLock);
+        if (processor->restoringSamplePresetName == presetName)
+            processor->restoringSamplePresetName.clear();
+    });
+}
+
 void PluginProcessor::clearSampleInstrument()
 {
+    pendingSamplePresetName.clear();
     sampleSynth.clearSample();
 }
 
-juce::File PluginProcessor::readSamplesPathFromConfig()
+juce::File PluginProcessor::getConfigDirectory()
 {
     // Platform-specific config location
 #if JUCE_MAC
-    juce::File configDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
         .getChildFile("NullyBeats/Demon Synth");
 #elif JUCE_WINDOWS
-    juce::File configDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
         .getChildFile("NullyBeats/Demon Synth");
 #else
-    juce::File configDir = juce::File::getSpecialLocation(juce::File::userHomeDirectory)
+    return juce::File::getSpecialLocation(juce::File::userHomeDirectory)
         .getChildFile(".config/NullyBeats/Demon Synth");
 #endif
+}
 
-    juce::File configFile = configDir.getChildFile("config.json");
+juce::File PluginProcessor::readSamplesPathFromConfig()
+{
+    juce::File configFile = getConfigDirectory().getChildFile("config.json");
 
     if (configFile.existsAsFile())
     {
@@ -37,7 +37,7 @@ public:
     bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 2.0; }
+    double getTailLengthSeconds() const override { return tailLengthSeconds.load(std::memory_order_relaxed); }
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -66,6 +66,9 @@ public:
     void loadSamplePreset(const juce::String& presetName);
     void clearSampleInstrument();
 
+    // Convolution reverb impulse response (decoded and partitioned in the background)
+    void loadConvolutionImpulse(const juce::File& file);
+
     // Get samples directory from config
     juce::File getSamplesDirectory();
 
@@ -112,6 +115,8 @@ public:
     const std::array<ModRowData, 5>& getModMatrixRows() const { return modMatrixRows; }
 
 private:
+    // Per-user settings folder (config.json, sample library index)
+    static juce::File getConfigDirectory();
     // Read config file for samples path + auth token
     juce::File readSamplesPathFromConfig();
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -122,6 +127,19 @@ private:
     // Write auth token + email back to config.json (preserves existing samplesPath)
     void saveAuthToConfig();
 
+    // Load a preset named by restored state; hosts may restore off the message thread
+    void restoreSamplePreset(const juce::String& presetName);
+
+    // Push the limiter parameters to the end of the FX rack
+    void updateLimiter();
+
+    // Global mod matrix: pick up staged routings, then evaluate one control quantum
+    void rebuildGlobalModMatrix();
+    void evaluateGlobalModulation(const juce::MidiBuffer& midi, int startSample, int numSamples);
+
+    // Apply the block's base FX values plus global modulation for one quantum
+    void applyFXModulation(int numSamples);
+
     // Synth engine
     Engine::VoiceManager voiceManager;
     Engine::SampleSynth sampleSynth;
@@ -130,8 +148,15 @@ private:
     // Effects
     DSP::FXRack fxRack;
 
-    // Global modulation
+    // Global modulation (FX destinations), evaluated once per control quantum.
+    // Routings are staged by the message thread and picked up by the audio thread.
+    static constexpr int GLOBAL_MOD_QUANTUM = 64;
     Modulation::ModMatrix globalModMatrix;
+    std::array<ModRowData, 5> pendingGlobalRows{};
+    juce::SpinLock globalRowsLock;
+    std::atomic<bool> globalRowsDirty{false};
+    float globalModWheel = 0.0f;
+    float globalAftertouch = 0.0f;
 
     // LFOs for global modulation
     DSP::LFO globalLFO1;
@@ -148,11 +173,23 @@ private:
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedChorusMix{0.5f};
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedFlangerMix{0.5f};
 
+    // Unmodulated FX values for the current block (modulation is added per quantum)
+    struct FXBaseValues
+    {
+        float reverbMix = 0.3f, delayMix = 0.3f, chorusMix = 0.5f, flangerMix = 0.5f;
+        float convolutionMix = 0.3f, chorusRate = 1.0f;
+    };
+    FXBaseValues fxBase;
+
     // Tempo sync
     double currentBPM = 120.0;
 
     // Currently loaded sample preset name (for state persistence)
     juce::String currentSamplePresetName;
+    juce::String pendingSamplePresetName;     // Waiting for the library rescan (message thread)
+    juce::String restoringSamplePresetName;   // Restored off the message thread, load not yet run
+    juce::CriticalSection restoringLock;      // Guards restoringSamplePresetName
+    juce::File convolutionImpulseFile;
 
     // Flag to track if setStateInformation has been called
     // This protects against FL Studio's bug where getState is called before setState
@@ -166,6 +203,10 @@ private:
     // Audio level metering
     std::atomic<float> currentRmsLevel{0.0f};
 
+    // Sleep when nothing is sounding; the tail is recomputed while awake
+    bool asleep = false;
+    std::atomic<double> tailLengthSeconds{2.0};
+
     // Oscilloscope buffer
     std::array<float, SCOPE_SIZE> scopeBuffer{};
     int scopeWritePos = 0;
@@ -178,6 +219,7 @@ private:
     // Mod matrix UI routing storage
     std::array<ModRowData, 5> modMatrixRows{};
 
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PluginProcessor)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
 
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Feedback delay network reverb (8 or 16 lines)
+ * - Lossless Hadamard feedback matrix, applied as an in-place fast
+ *   Walsh-Hadamard transform (N log N adds, no multiplies until the scale)
+ * - All per-line state lives in aligned NumLines-wide arrays so every stage
+ *   (read, damping, matrix, write-back) is a straight vector loop
+ * - Each line's read tap is slowly modulated to break up metallic modes
+ * - Decay is set as RT60; per-line gains are derived from the line lengths
+ */
+template <int NumLines>
+class FDNReverb
+{
+    static_assert(NumLines == 8 || NumLines == 16, "FDNReverb supports 8 or 16 lines");
+
+public:
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        const auto& lengthsMs = getLineLengthsMs();
+        const float modDepth = MOD_DEPTH_MS * 0.001f * static_cast<float>(sampleRate);
+
+        writeMask = 0;
+
+        for (int i = 0; i < NumLines; ++i)
+        {
+            const size_t idx = static_cast<size_t>(i);
+            baseDelay[idx] = lengthsMs[idx] * 0.001f * static_cast<float>(sampleRate);
+
+            // Room for the modulation swing plus the interpolator's neighbour
+            const int required = static_cast<int>(std::ceil(baseDelay[idx] + modDepth)) + 2;
+            const int size = juce::nextPowerOfTwo(required);
+            lines[idx].assign(static_cast<size_t>(size), 0.0f);
+            masks[idx] = size - 1;
+            writeMask = std::max(writeMask, size - 1);
+
+            // Spread modulation rates between ~0.3 and ~1.1 Hz
+            const float rate = 0.3f + 0.8f * static_cast<float>(i) / static_cast<float>(NumLines - 1);
+            const float w = juce::MathConstants<float>::twoPi * rate / static_cast<float>(sampleRate);
+            rotCos[idx] = std::cos(w);
+            rotSin[idx] = std::sin(w);
+        }
+
+        modDepthSamples = modDepth;
+        reset();
+        updateDecay();
+    }
+
+    void reset()
+    {
+        for (auto& line : lines)
+            std::fill(line.begin(), line.end(), 0.0f);
+
+        dampState.fill(0.0f);
+        writePos = 0;
+
+        // Start each modulator at a different phase
+        for (int i = 0; i < NumLines; ++i)
+        {
+            const float phase = juce::MathConstants<float>::twoPi * static_cast<float>(i) / NumLines;
+            modCos[static_cast<size_t>(i)] = std::cos(phase);
+            modSin[static_cast<size_t>(i)] = std::sin(phase);
+        }
+    }
+
+    // Room size 0-1 maps to RT60 of roughly 0.3s - 8s
+    void setRoomSize(float size)
+    {
+        const float newRt60 = 0.3f + 7.7f * size * size;
+        if (newRt60 != rt60)
+        {
+            rt60 = newRt60;
+            updateDecay();
+        }
+    }
+
+    // Damping 0-1: high-frequency loss per pass through the network
+    void setDamping(float damping)
+    {
+        dampCoeff = juce::jlimit(0.0f, 1.0f, damping) * 0.85f;
+    }
+
+    // Width 0-1: 0 = mono wet signal, 1 = fully decorrelated
+    void setWidth(float newWidth)
+    {
+        width = juce::jlimit(0.0f, 1.0f, newWidth);
+    }
+
+    float getRT60() const { return rt60; }
+    float getLongestLineSeconds() const { return getLineLengthsMs()[NumLines - 1] * 0.001f; }
+
+    // In-place stereo processing: left/right become dry * (1 - mix) + wet * mix
+    void process(float* left, float* right, int numSamples, float mix)
+    {
+        const float dryGain = 1.0f - mix;
+        const float wetGain = mix * OUTPUT_GAIN;
+        const float wet1 = wetGain * (0.5f + 0.5f * width);
+        const float wet2 = wetGain * (0.5f - 0.5f * width);
+        const float damp = dampCoeff;
+
+        alignas(32) std::array<float, NumLines> x;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const float inL = left[n];
+            const float inR = right[n];
+
+            // Modulated reads (linear interpolation is enough for sub-10-sample swings)
+            for (int i = 0; i < NumLines; ++i)
+            {
+                const size_t idx = static_cast<size_t>(i);
+                const float d = baseDelay[idx] + modDepthSamples * modSin[idx];
+                const int whole = static_cast<int>(d);
+                const float frac = d - static_cast<float>(whole);
+                const int mask = masks[idx];
+                const float* line = lines[idx].data();
+                const float a = line[(writePos - whole) & mask];
+                const float b = line[(writePos - whole - 1) & mask];
+                x[idx] = a + (b - a) * frac;
+            }
+
+            // One-pole lowpass in each line (high frequencies decay faster)
+            for (size_t i = 0; i < static_cast<size_t>(NumLines); ++i)
+            {
+                dampState[i] = x[i] + damp * (dampState[i] - x[i]);
+                x[i] = dampState[i];
+            }
+
+            // Decorrelated stereo taps: alternate signs across the lines
+            float outA = 0.0f, outB = 0.0f;
+            for (size_t i = 0; i < static_cast<size_t>(NumLines); ++i)
+            {
+                outA += x[i] * outputSignsA[i];
+                outB += x[i] * outputSignsB[i];
+            }
+
+            // Lossless mixing
+            hadamard(x);
+
+            // Per-line decay gain, inject input, write back
+            for (size_t i = 0; i < static_cast<size_t>(NumLines); ++i)
+            {
+                const float in = (i & 1) ? inR : inL;
+                lines[i][static_cast<size_t>(writePos & masks[i])] = x[i] * lineGain[i] + in * inputSigns[i] * INPUT_GAIN;
+            }
+
+            // Line sizes are powers of two, so wrapping at the largest keeps every mask valid
+            writePos = (writePos + 1) & writeMask;
+
+            advanceModulators();
+
+            left[n]  = inL * dryGain + outA * wet1 + outB * wet2;
+            right[n] = inR * dryGain + outB * wet1 + outA * wet2;
+        }
+
+        // Keep the rotating phasors on the unit circle
+        normaliseModulators();
+    }
+
+private:
+    static constexpr float MOD_DEPTH_MS = 0.12f;
+    static constexpr float INPUT_GAIN = 0.35f;
+    static constexpr float OUTPUT_GAIN = 0.5f;
+
+    // Mutually prime-ish lengths, spread so modes don't stack up
+    static const std::array<float, NumLines>& getLineLengthsMs()
+    {
+        static const std::array<float, NumLines> lengths = [] {
+            constexpr std::array<float, 16> all = {
+                29.7f, 33.1f, 37.1f, 41.1f, 43.7f, 47.3f, 53.9f, 59.3f,
+                61.7f, 67.1f, 71.3f, 73.9f, 79.7f, 83.3f, 89.9f, 97.1f
+            };
+            std::array<float, NumLines> l{};
+            constexpr int stride = 16 / NumLines;
+            for (int i = 0; i < NumLines; ++i)
+                l[static_cast<size_t>(i)] = all[static_cast<size_t>(i * stride)];
+            return l;
+        }();
+        return lengths;
+    }
+
+    // Fast Walsh-Hadamard transform, normalised to be orthogonal
+    static void hadamard(std::array<float, NumLines>& x)
+    {
+        for (int h = 1; h < NumLines; h *= 2)
+        {
+            for (int i = 0; i < NumLines; i += h * 2)
+            {
+                for (int j = i; j < i + h; ++j)
+                {
+                    const float a = x[static_cast<size_t>(j)];
+                    const float b = x[static_cast<size_t>(j + h)];
+                    x[static_cast<size_t>(j)] = a + b;
+                    x[static_cast<size_t>(j + h)] = a - b;
+                }
+            }
+        }
+
+        const float scale = 1.0f / std::sqrt(static_cast<float>(NumLines));
+        for (auto& v : x)
+            v *= scale;
+    }
+
+    void updateDecay()
+    {
+        // Gain per pass so each line loses 60 dB over rt60 seconds
+        for (size_t i = 0; i < static_cast<size_t>(NumLines); ++i)
+        {
+            const float seconds = baseDelay[i] / static_cast<float>(sampleRate);
+            lineGain[i] = std::pow(10.0f, -3.0f * seconds / rt60);
+        }
+    }
+
+    void advanceModulators()
+    {
+        for (size_t i = 0; i < static_cast<size_t>(NumLines); ++i)
+        {
+            const float c = modCos[i];
+            const float s = modSin[i];
+            modCos[i] = c * rotCos[i] - s * rotSin[i];
+            modSin[i] = s * rotCos[i] + c * rotSin[i];
+        }
+    }
+
+    void normaliseModulators()
+    {
+        for (size_t i = 0; i < static_cast<size_t>(NumLines); ++i)
+        {
+            const float mag = std::sqrt(modCos[i] * modCos[i] + modSin[i] * modSin[i]);
+            const float inv = mag > 0.0f ? 1.0f / mag : 1.0f;
+            modCos[i] *= inv;
+            modSin[i] *= inv;
+        }
+    }
+
+    static constexpr std::array<float, NumLines> makeAlternating(int period)
+    {
+        std::array<float, NumLines> s{};
+        for (int i = 0; i < NumLines; ++i)
+            s[static_cast<size_t>(i)] = ((i / period) % 2 == 0) ? 1.0f : -1.0f;
+        return s;
+    }
+
+    static constexpr std::array<float, NumLines> inputSigns = makeAlternating(2);
+    static constexpr std::array<float, NumLines> outputSignsA = makeAlternating(1);
+    static constexpr std::array<float, NumLines> outputSignsB = makeAlternating(4);
+
+    double sampleRate = 44100.0;
+
+    std::array<std::vector<float>, NumLines> lines;
+    std::array<int, NumLines> masks{};
+    int writePos = 0;
+    int writeMask = 0;
+
+    alignas(32) std::array<float, NumLines> baseDelay{};
+    alignas(32) std::array<float, NumLines> lineGain{};
+    alignas(32) std::array<float, NumLines> dampState{};
+    alignas(32) std::array<float, NumLines> modCos{};
+    alignas(32) std::array<float, NumLines> modSin{};
+    alignas(32) std::array<float, NumLines> rotCos{};
+    alignas(32) std::array<float, NumLines> rotSin{};
+
+    float modDepthSamples = 0.0f;
+    float rt60 = 2.0f;
+    float dampCoeff = 0.4f;
+    float width = 1.0f;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
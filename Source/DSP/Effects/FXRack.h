@@ -1,9 +1,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../Filters/Biquad.h"
+#include "FDNReverb.h"
+#include "Limiter.h"
+#include "ModulatedDelay.h"
+#include "PartitionedConvolver.h"
+#include "Waveshapers.h"
 #include <vector>
 #include <memory>
 #include <array>
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace NulyBeats {
 namespace DSP {
@@ -28,17 +39,68 @@ public:
     void setMix(float mix) { this->mix = juce::jlimit(0.0f, 1.0f, mix); }
     float getMix() const { return mix; }
 
+    // How long the output keeps sounding after the input goes silent, for the
+    // current settings. Effects without memory keep the default of zero.
+    virtual double getTailLengthSeconds() const { return 0.0; }
+
+    // Tail bookkeeping for FXRack: restarted on every block with input, run down
+    // on silent ones. Once it reaches zero the output is silent and can be skipped.
+    void restartTail() { tailSamplesRemaining = static_cast<juce::int64>(std::ceil(getTailLengthSeconds() * sampleRate)); }
+    void consumeTail(int numSamples) { tailSamplesRemaining = std::max<juce::int64>(0, tailSamplesRemaining - numSamples); }
+    bool isTailActive() const { return tailSamplesRemaining > 0; }
+
 protected:
+    // Passes through a feedback loop until the recirculated signal is below -96 dB
+    static double repeatsToSilence(float feedback)
+    {
+        const double g = std::abs(static_cast<double>(feedback));
+        if (g < 1.0e-3)
+            return 1.0;
+        return 1.0 + std::ceil(std::log(SILENCE_GAIN) / std::log(g));
+    }
+
+    static constexpr double SILENCE_GAIN = 1.5849e-5;  // -96 dB
+
+    // Runs an in-place stereo kernel fn(left, right, numSamples). A mono buffer
+    // is fed to both inputs in stack-sized chunks and the outputs are averaged.
+    template <typename StereoFn>
+    static void processStereoOrMono(juce::AudioBuffer<float>& buffer, StereoFn&& fn)
+    {
+        const int numSamples = buffer.getNumSamples();
+        float* left = buffer.getWritePointer(0);
+
+        if (buffer.getNumChannels() > 1)
+        {
+            fn(left, buffer.getWritePointer(1), numSamples);
+            return;
+        }
+
+        constexpr int chunk = 256;
+        std::array<float, chunk> scratch;
+        for (int start = 0; start < numSamples; start += chunk)
+        {
+            const int n = std::min(chunk, numSamples - start);
+            std::copy(left + start, left + start + n, scratch.begin());
+            fn(left + start, scratch.data(), n);
+            for (int i = 0; i < n; ++i)
+                left[start + i] = 0.5f * (left[start + i] + scratch[static_cast<size_t>(i)]);
+        }
+    }
+
     bool enabled = true;
     float mix = 1.0f;
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
+
+private:
+    juce::int64 tailSamplesRemaining = 0;
 };
 
 /**
- * Stereo Reverb (algorithmic)
+ * Stereo Reverb (8-line feedback delay network)
+ * Wet/dry is mixed in place inside the network's sample loop - no dry copy.
  */
-class ReverbEffect : public Effect
+class ReverbEffect final : public Effect
 {
 public:
     void prepare(double sr, int blockSize) override
@@ -46,16 +108,7 @@ public:
         sampleRate = sr;
         samplesPerBlock = blockSize;
 
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sr;
-        spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
-        spec.numChannels = 2;
-
-        reverb.prepare(spec);
-
-        // Pre-allocate dry buffer to avoid allocation during processing
-        dryBuffer.setSize(2, blockSize);
-
+        reverb.prepare(sr);
         updateParameters();
     }
 
@@ -64,36 +117,7 @@ public:
         if (!enabled)
             return;
 
-        const int numChannels = buffer.getNumChannels();
-        const int numSamples = buffer.getNumSamples();
-
-        // Ensure dry buffer is large enough (without reallocation if possible)
-        if (dryBuffer.getNumSamples() < numSamples || dryBuffer.getNumChannels() < numChannels)
-            dryBuffer.setSize(numChannels, numSamples, false, false, true);
-
-        // Copy dry signal without allocation
-        for (int ch = 0; ch < numChannels; ++ch)
-            dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-
-        // Apply reverb
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        reverb.process(context);
-
-        // Mix
-        if (mix < 1.0f)
-        {
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                float* wet = buffer.getWritePointer(ch);
-                const float* dry = dryBuffer.getReadPointer(ch);
-
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    wet[i] = dry[i] * (1.0f - mix) + wet[i] * mix;
-                }
-            }
-        }
+        processStereoOrMono(buffer, [this](float* l, float* r, int n) { reverb.process(l, r, n, mix); });
     }
 
     void reset() override
@@ -103,113 +127,154 @@ public:
 
     juce::String getName() const override { return "Reverb"; }
 
+    // RT60 is the time to -60 dB; scale it out to the -96 dB silence floor
+    double getTailLengthSeconds() const override
+    {
+        return reverb.getRT60() * (96.0 / 60.0) + reverb.getLongestLineSeconds();
+    }
+
     void setRoomSize(float size)
     {
-        params.roomSize = juce::jlimit(0.0f, 1.0f, size);
+        roomSize = juce::jlimit(0.0f, 1.0f, size);
         updateParameters();
     }
 
     void setDamping(float damp)
     {
-        params.damping = juce::jlimit(0.0f, 1.0f, damp);
+        damping = juce::jlimit(0.0f, 1.0f, damp);
         updateParameters();
     }
 
-    void setWidth(float width)
+    void setWidth(float newWidth)
     {
-        params.width = juce::jlimit(0.0f, 1.0f, width);
+        width = juce::jlimit(0.0f, 1.0f, newWidth);
         updateParameters();
     }
 
 private:
     void updateParameters()
     {
-        reverb.setParameters(params);
+        reverb.setRoomSize(roomSize);
+        reverb.setDamping(damping);
+        reverb.setWidth(width);
     }
 
-    juce::dsp::Reverb reverb;
-    juce::dsp::Reverb::Parameters params;
-    juce::AudioBuffer<float> dryBuffer;
+    FDNReverb<8> reverb;
+
+    float roomSize = 0.5f;
+    float damping = 0.5f;
+    float width = 1.0f;
 };
 
 /**
- * Stereo Delay with sync and feedback
+ * Stereo Delay with sync, feedback and multi-tap
+ * - Lines sized to MAX_DELAY_SECONDS at the actual sample rate, rounded up to
+ *   a power of two so wrapping is a mask
+ * - Delay time is smoothed and read with 4-point Hermite interpolation, so
+ *   time changes and modulation glide instead of clicking
+ * - reset() is lazy: history older than the last clear reads as silence
+ *   rather than being zero-filled
  */
-class DelayEffect : public Effect
+class DelayEffect final : public Effect
 {
 public:
-    static constexpr int MAX_DELAY_SAMPLES = 192000 * 2; // 2 seconds at 192kHz
+    static constexpr float MAX_DELAY_SECONDS = 2.0f;
+    static constexpr int MAX_TAPS = 4;
 
     void prepare(double sr, int blockSize) override
     {
         sampleRate = sr;
         samplesPerBlock = blockSize;
 
-        delayLineL.resize(MAX_DELAY_SAMPLES);
-        delayLineR.resize(MAX_DELAY_SAMPLES);
-        reset();
+        // +4 leaves room for the interpolator's neighbours at the maximum delay
+        const int required = static_cast<int>(std::ceil(MAX_DELAY_SECONDS * sr)) + 4;
+        const int size = juce::nextPowerOfTwo(required);
+
+        delayLineL.assign(static_cast<size_t>(size), 0.0f);
+        delayLineR.assign(static_cast<size_t>(size), 0.0f);
+        mask = size - 1;
+
+        // ~50ms glide for time changes
+        smoothingCoeff = 1.0f - std::exp(-1.0f / (0.05f * static_cast<float>(sr)));
+
+        writePos = 0;
+        samplesWritten = size;  // Freshly allocated lines are already silent
+        currentDelayL = targetDelaySamples(delayTimeL);
+        currentDelayR = targetDelaySamples(delayTimeR);
     }
 
     void process(juce::AudioBuffer<float>& buffer) override
     {
-        if (!enabled)
+        if (!enabled || delayLineL.empty())
             return;
 
         float* left = buffer.getWritePointer(0);
         float* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : left;
 
+        const float targetL = targetDelaySamples(delayTimeL);
+        const float targetR = targetDelaySamples(delayTimeR);
+        const float straightFeedback = feedback * (1.0f - pingPong);
+        const float crossFeedback = feedback * pingPong;
+
         for (int i = 0; i < buffer.getNumSamples(); ++i)
         {
-            // Read from delay lines
-            float delayedL = readDelay(delayLineL, readPosL);
-            float delayedR = readDelay(delayLineR, readPosR);
-
-            // Cross-feedback for ping-pong
-            float inputL = left[i] + delayedR * feedback * pingPong;
-            float inputR = right[i] + delayedL * feedback * pingPong;
+            currentDelayL += (targetL - currentDelayL) * smoothingCoeff;
+            currentDelayR += (targetR - currentDelayR) * smoothingCoeff;
 
-            // Normal feedback
-            inputL += delayedL * feedback * (1.0f - pingPong);
-            inputR += delayedR * feedback * (1.0f - pingPong);
+            // The last tap is the full delay time and carries the feedback
+            float delayedL = readDelay(delayLineL, currentDelayL);
+            float delayedR = readDelay(delayLineR, currentDelayR);
 
-            // Write to delay lines
-            delayLineL[writePos] = inputL;
-            delayLineR[writePos] = inputR;
+            // Cross-feedback for ping-pong plus normal feedback
+            float inputL = left[i] + delayedR * crossFeedback + delayedL * straightFeedback;
+            float inputR = right[i] + delayedL * crossFeedback + delayedR * straightFeedback;
 
-            // Output mix
-            left[i] = left[i] * (1.0f - mix) + delayedL * mix;
-            right[i] = right[i] * (1.0f - mix) + delayedR * mix;
+            // Earlier taps subdivide the delay time and are panned into the output only
+            float wetL = delayedL;
+            float wetR = delayedR;
+            for (int t = 0; t < numTaps - 1; ++t)
+            {
+                const auto& tap = taps[static_cast<size_t>(t)];
+                float tapSample = 0.5f * (readDelay(delayLineL, currentDelayL * tap.position)
+                                        + readDelay(delayLineR, currentDelayR * tap.position));
+                wetL += tapSample * tap.gainL;
+                wetR += tapSample * tap.gainR;
+            }
 
-            // Advance positions
-            ++writePos;
-            if (writePos >= MAX_DELAY_SAMPLES)
-                writePos = 0;
+            // Write to delay lines
+            delayLineL[static_cast<size_t>(writePos)] = inputL;
+            delayLineR[static_cast<size_t>(writePos)] = inputR;
+            writePos = (writePos + 1) & mask;
 
-            ++readPosL;
-            if (readPosL >= MAX_DELAY_SAMPLES)
-                readPosL = 0;
+            if (samplesWritten <= mask)
+                ++samplesWritten;
 
-            ++readPosR;
-            if (readPosR >= MAX_DELAY_SAMPLES)
-                readPosR = 0;
+            // Output mix
+            left[i] = left[i] * (1.0f - mix) + wetL * mix;
+            right[i] = right[i] * (1.0f - mix) + wetR * mix;
         }
     }
 
     void reset() override
     {
-        std::fill(delayLineL.begin(), delayLineL.end(), 0.0f);
-        std::fill(delayLineR.begin(), delayLineR.end(), 0.0f);
-        writePos = 0;
-        updateReadPositions();
+        // Lazy clear: anything older than samplesWritten is treated as silence
+        samplesWritten = 0;
+        currentDelayL = targetDelaySamples(delayTimeL);
+        currentDelayR = targetDelaySamples(delayTimeR);
     }
 
     juce::String getName() const override { return "Delay"; }
 
+    double getTailLengthSeconds() const override
+    {
+        const float longest = std::max(targetDelaySamples(delayTimeL), targetDelaySamples(delayTimeR));
+        return repeatsToSilence(feedback) * longest / sampleRate;
+    }
+
     void setDelayTime(float seconds)
     {
-        delayTimeL = juce::jlimit(0.001f, 2.0f, seconds);
+        delayTimeL = juce::jlimit(0.001f, MAX_DELAY_SECONDS, seconds);
         delayTimeR = delayTimeL;
-        updateReadPositions();
     }
 
     void setDelayTimeSync(double bpm, float beatDivision)
@@ -218,66 +283,132 @@ public:
         setDelayTime(seconds);
     }
 
+    // Delay time modulation in octaves (+1 doubles, -1 halves), applied on top of the set time
+    void setDelayTimeModulation(float octaves)
+    {
+        timeModulation = std::exp2(juce::jlimit(-2.0f, 2.0f, octaves));
+    }
+
     void setFeedback(float fb) { feedback = juce::jlimit(0.0f, 0.99f, fb); }
     void setPingPong(float pp) { pingPong = juce::jlimit(0.0f, 1.0f, pp); }
 
+    // Evenly subdivide the delay time into 1-4 taps; inner taps alternate left/right
+    void setNumTaps(int newNumTaps)
+    {
+        newNumTaps = juce::jlimit(1, MAX_TAPS, newNumTaps);
+        if (newNumTaps == numTaps)
+            return;
+
+        numTaps = newNumTaps;
+        for (int t = 0; t < numTaps - 1; ++t)
+        {
+            auto& tap = taps[static_cast<size_t>(t)];
+            tap.position = static_cast<float>(t + 1) / static_cast<float>(numTaps);
+
+            const float pan = (t % 2 == 0) ? -0.6f : 0.6f;
+            const float angle = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+            const float gain = 0.8f;
+            tap.gainL = std::cos(angle) * gain;
+            tap.gainR = std::sin(angle) * gain;
+        }
+    }
+
+    int getNumTaps() const { return numTaps; }
+
 private:
-    float readDelay(const std::vector<float>& line, int readPos) const
+    struct Tap
+    {
+        float position = 1.0f;  // Fraction of the full delay time
+        float gainL = 0.0f;
+        float gainR = 0.0f;
+    };
+
+    float targetDelaySamples(float seconds) const
     {
-        return line[readPos];
+        const float maxDelay = static_cast<float>(mask - 2);
+        return juce::jlimit(2.0f, maxDelay, seconds * timeModulation * static_cast<float>(sampleRate));
     }
 
-    void updateReadPositions()
+    // 4-point, 3rd-order Hermite read at a fractional delay (in samples)
+    float readDelay(const std::vector<float>& line, float delaySamples) const
     {
-        int delaySamplesL = static_cast<int>(delayTimeL * sampleRate);
-        int delaySamplesR = static_cast<int>(delayTimeR * sampleRate);
+        const int whole = static_cast<int>(delaySamples);
+        const float t = delaySamples - static_cast<float>(whole);
 
-        delaySamplesL = std::min(delaySamplesL, MAX_DELAY_SAMPLES - 1);
-        delaySamplesR = std::min(delaySamplesR, MAX_DELAY_SAMPLES - 1);
+        float ym1, y0, y1, y2;
+        if (whole + 2 <= samplesWritten)
+        {
+            const int base = writePos - whole;
+            ym1 = line[static_cast<size_t>((base + 1) & mask)];
+            y0  = line[static_cast<size_t>(base & mask)];
+            y1  = line[static_cast<size_t>((base - 1) & mask)];
+            y2  = line[static_cast<size_t>((base - 2) & mask)];
+        }
+        else
+        {
+            // Straddling the last lazy clear: stale history reads as zero
+            ym1 = readWritten(line, whole - 1);
+            y0  = readWritten(line, whole);
+            y1  = readWritten(line, whole + 1);
+            y2  = readWritten(line, whole + 2);
+        }
 
-        readPosL = writePos - delaySamplesL;
-        if (readPosL < 0)
-            readPosL += MAX_DELAY_SAMPLES;
+        const float c1 = 0.5f * (y1 - ym1);
+        const float c2 = ym1 - 2.5f * y0 + 2.0f * y1 - 0.5f * y2;
+        const float c3 = 0.5f * (y2 - ym1) + 1.5f * (y0 - y1);
+        return ((c3 * t + c2) * t + c1) * t + y0;
+    }
 
-        readPosR = writePos - delaySamplesR;
-        if (readPosR < 0)
-            readPosR += MAX_DELAY_SAMPLES;
+    float readWritten(const std::vector<float>& line, int age) const
+    {
+        return age <= samplesWritten ? line[static_cast<size_t>((writePos - age) & mask)] : 0.0f;
     }
 
     std::vector<float> delayLineL;
     std::vector<float> delayLineR;
+    int mask = 0;
     int writePos = 0;
-    int readPosL = 0;
-    int readPosR = 0;
+    int samplesWritten = 0;
 
     float delayTimeL = 0.5f;
     float delayTimeR = 0.5f;
+    float timeModulation = 1.0f;
+    float currentDelayL = 0.0f;
+    float currentDelayR = 0.0f;
+    float smoothingCoeff = 1.0f;
     float feedback = 0.5f;
     float pingPong = 0.0f;
+
+    std::array<Tap, MAX_TAPS> taps{};
+    int numTaps = 1;
 };
 
 /**
- * Stereo Chorus
+ * Stereo Chorus / Ensemble on the shared modulated-delay kernel
+ * - Chorus: one voice per channel, quadrature L/R modulation
+ * - Ensemble: three voices 120 degrees apart per channel (string-machine style)
  */
-class ChorusEffect : public Effect
+class ChorusEffect final : public Effect
 {
 public:
+    enum class Mode
+    {
+        Chorus,
+        Ensemble
+    };
+
     void prepare(double sr, int blockSize) override
     {
         sampleRate = sr;
         samplesPerBlock = blockSize;
 
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sr;
-        spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
-        spec.numChannels = 2;
-
-        chorus.prepare(spec);
-        chorus.setRate(1.0f);
-        chorus.setDepth(0.25f);
-        chorus.setCentreDelay(7.0f);
-        chorus.setFeedback(-0.2f);
-        chorus.setMix(0.5f);
+        kernel.prepare(sr, MAX_DELAY_MS);
+        kernel.setCentreDelay(CENTRE_DELAY_MS);
+        kernel.setFeedback(-0.2f);
+        kernel.setStereoPhase(0.25f);
+        updateDepth();
+        kernel.setRate(rate);
+        kernel.setNumVoices(getNumVoices(mode));
     }
 
     void process(juce::AudioBuffer<float>& buffer) override
@@ -285,32 +416,72 @@ public:
         if (!enabled)
             return;
 
-        chorus.setMix(mix);
-
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        chorus.process(context);
+        processStereoOrMono(buffer, [this](float* l, float* r, int n) {
+            kernel.process(l, r, n, 1.0f - mix, mix);
+        });
     }
 
     void reset() override
     {
-        chorus.reset();
+        kernel.reset();
     }
 
     juce::String getName() const override { return "Chorus"; }
 
-    void setRate(float rate) { chorus.setRate(rate); }
-    void setDepth(float depth) { chorus.setDepth(depth); }
-    void setFeedback(float fb) { chorus.setFeedback(fb); }
+    double getTailLengthSeconds() const override
+    {
+        return repeatsToSilence(kernel.getFeedback()) * kernel.getLongestDelaySeconds();
+    }
+
+    void setRate(float r)
+    {
+        if (r != rate)
+        {
+            rate = r;
+            kernel.setRate(rate);
+        }
+    }
+
+    void setDepth(float d)
+    {
+        const float newDepth = juce::jlimit(0.0f, 1.0f, d);
+        if (newDepth != depth)
+        {
+            depth = newDepth;
+            updateDepth();
+        }
+    }
+
+    void setFeedback(float fb) { kernel.setFeedback(fb); }
+
+    void setMode(Mode m)
+    {
+        if (m != mode)
+        {
+            mode = m;
+            kernel.setNumVoices(getNumVoices(mode));
+        }
+    }
 
 private:
-    juce::dsp::Chorus<float> chorus;
+    static constexpr float MAX_DELAY_MS = 20.0f;
+    static constexpr float CENTRE_DELAY_MS = 7.0f;
+    static constexpr float MAX_SWING_MS = 5.0f;
+
+    static int getNumVoices(Mode m) { return m == Mode::Ensemble ? 3 : 1; }
+    void updateDepth() { kernel.setDepth(depth * MAX_SWING_MS); }
+
+    ModulatedDelay kernel;
+    Mode mode = Mode::Chorus;
+    float rate = 1.0f;
+    float depth = 0.25f;
 };
 
 /**
  * Stereo Flanger - shorter delay than chorus with higher feedback for "jet" sound
+ * Runs on the shared modulated-delay kernel with a single voice per channel.
  */
-class FlangerEffect : public Effect
+class FlangerEffect final : public Effect
 {
 public:
     void prepare(double sr, int blockSize) override
@@ -319,12 +490,13 @@ public:
         samplesPerBlock = blockSize;
 
         // Flanger uses short delay lines (max ~20ms)
-        int maxDelaySamples = static_cast<int>(0.02 * sr) + 1;
-        delayLineL.resize(static_cast<size_t>(maxDelaySamples));
-        delayLineR.resize(static_cast<size_t>(maxDelaySamples));
-        maxDelay = maxDelaySamples;
-
-        reset();
+        kernel.prepare(sr, 20.0f);
+        kernel.setNumVoices(1);
+        kernel.setCentreDelay(CENTRE_DELAY_MS);
+        kernel.setRate(rate);
+        kernel.setFeedback(feedback);
+        kernel.setStereoPhase(stereoSpread);
+        updateDepth();
     }
 
     void process(juce::AudioBuffer<float>& buffer) override
@@ -332,90 +504,66 @@ public:
         if (!enabled)
             return;
 
-        float* left = buffer.getWritePointer(0);
-        float* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : left;
-
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            // Update LFO
-            float lfoValue = std::sin(lfoPhase * 2.0f * juce::MathConstants<float>::pi);
-            lfoPhase += static_cast<float>(rate / sampleRate);
-            if (lfoPhase >= 1.0f)
-                lfoPhase -= 1.0f;
-
-            // Calculate modulated delay time (0.1ms to 10ms range)
-            float minDelayMs = 0.1f;
-            float maxDelayMs = 10.0f;
-            float centreDelayMs = (minDelayMs + maxDelayMs) * 0.5f;
-            float delayRangeMs = (maxDelayMs - minDelayMs) * 0.5f * depth;
-
-            float delayMs = centreDelayMs + lfoValue * delayRangeMs;
-            float delaySamples = static_cast<float>(delayMs * 0.001 * sampleRate);
-            delaySamples = juce::jlimit(1.0f, static_cast<float>(maxDelay - 1), delaySamples);
-
-            // Stereo spread - offset phase for right channel
-            float lfoValueR = std::sin((lfoPhase + stereoSpread) * 2.0f * juce::MathConstants<float>::pi);
-            float delayMsR = centreDelayMs + lfoValueR * delayRangeMs;
-            float delaySamplesR = static_cast<float>(delayMsR * 0.001 * sampleRate);
-            delaySamplesR = juce::jlimit(1.0f, static_cast<float>(maxDelay - 1), delaySamplesR);
-
-            // Read from delay lines with linear interpolation
-            float delayedL = readDelayInterp(delayLineL, delaySamples);
-            float delayedR = readDelayInterp(delayLineR, delaySamplesR);
-
-            // Write to delay lines with feedback
-            delayLineL[static_cast<size_t>(writePos)] = left[i] + delayedL * feedback;
-            delayLineR[static_cast<size_t>(writePos)] = right[i] + delayedR * feedback;
-
-            // Output mix
-            float dryL = left[i];
-            float dryR = right[i];
-            left[i] = dryL * (1.0f - mix) + (dryL + delayedL) * 0.5f * mix;
-            right[i] = dryR * (1.0f - mix) + (dryR + delayedR) * 0.5f * mix;
-
-            // Advance write position
-            ++writePos;
-            if (writePos >= maxDelay)
-                writePos = 0;
-        }
+        // Output is dry * (1 - mix) + (dry + delayed) * 0.5 * mix
+        processStereoOrMono(buffer, [this](float* l, float* r, int n) {
+            kernel.process(l, r, n, 1.0f - 0.5f * mix, 0.5f * mix);
+        });
     }
 
     void reset() override
     {
-        std::fill(delayLineL.begin(), delayLineL.end(), 0.0f);
-        std::fill(delayLineR.begin(), delayLineR.end(), 0.0f);
-        writePos = 0;
-        lfoPhase = 0.0f;
+        kernel.reset();
     }
 
     juce::String getName() const override { return "Flanger"; }
 
-    void setRate(float r) { rate = juce::jlimit(0.05f, 10.0f, r); }
-    void setDepth(float d) { depth = juce::jlimit(0.0f, 1.0f, d); }
-    void setFeedback(float fb) { feedback = juce::jlimit(-0.95f, 0.95f, fb); }
-    void setStereoSpread(float spread) { stereoSpread = juce::jlimit(0.0f, 0.5f, spread); }
+    double getTailLengthSeconds() const override
+    {
+        return repeatsToSilence(feedback) * kernel.getLongestDelaySeconds();
+    }
 
-private:
-    float readDelayInterp(const std::vector<float>& line, float delaySamples) const
+    // Setters only touch the kernel on change - the WARP macro calls them every block
+    void setRate(float r)
     {
-        float readPos = static_cast<float>(writePos) - delaySamples;
-        if (readPos < 0.0f)
-            readPos += static_cast<float>(maxDelay);
+        const float newRate = juce::jlimit(0.05f, 10.0f, r);
+        if (newRate != rate)
+        {
+            rate = newRate;
+            kernel.setRate(rate);
+        }
+    }
 
-        int pos0 = static_cast<int>(readPos);
-        int pos1 = pos0 + 1;
-        if (pos1 >= maxDelay)
-            pos1 = 0;
+    void setDepth(float d)
+    {
+        const float newDepth = juce::jlimit(0.0f, 1.0f, d);
+        if (newDepth != depth)
+        {
+            depth = newDepth;
+            updateDepth();
+        }
+    }
 
-        float frac = readPos - static_cast<float>(pos0);
-        return line[static_cast<size_t>(pos0)] * (1.0f - frac) + line[static_cast<size_t>(pos1)] * frac;
+    void setFeedback(float fb)
+    {
+        feedback = juce::jlimit(-0.95f, 0.95f, fb);
+        kernel.setFeedback(feedback);
     }
 
-    std::vector<float> delayLineL;
-    std::vector<float> delayLineR;
-    int writePos = 0;
-    int maxDelay = 0;
-    float lfoPhase = 0.0f;
+    void setStereoSpread(float spread)
+    {
+        stereoSpread = juce::jlimit(0.0f, 0.5f, spread);
+        kernel.setStereoPhase(stereoSpread);
+    }
+
+private:
+    // Delay sweeps 0.1ms - 10ms at full depth
+    static constexpr float MIN_DELAY_MS = 0.1f;
+    static constexpr float MAX_DELAY_MS = 10.0f;
+    static constexpr float CENTRE_DELAY_MS = (MIN_DELAY_MS + MAX_DELAY_MS) * 0.5f;
+
+    void updateDepth() { kernel.setDepth((MAX_DELAY_MS - MIN_DELAY_MS) * 0.5f * depth); }
+
+    ModulatedDelay kernel;
 
     float rate = 0.5f;      // LFO rate in Hz
     float depth = 0.7f;     // Modulation depth
@@ -426,7 +574,7 @@ private:
 /**
  * Distortion / Saturation
  */
-class DistortionEffect : public Effect
+class DistortionEffect final : public Effect
 {
 public:
     enum class Type
@@ -438,10 +586,19 @@ public:
         Bitcrush
     };
 
+    // Antiderivative anti-aliasing order
+    enum class Antialiasing
+    {
+        Off,
+        FirstOrder,   // Half-sample delay, ~most of the benefit of 2x-4x oversampling
+        SecondOrder   // One-sample delay, stronger rejection at high drive
+    };
+
     void prepare(double sr, int blockSize) override
     {
         sampleRate = sr;
         samplesPerBlock = blockSize;
+        reset();
     }
 
     void process(juce::AudioBuffer<float>& buffer) override
@@ -449,72 +606,191 @@ public:
         if (!enabled)
             return;
 
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        {
-            float* samples = buffer.getWritePointer(ch);
+        const int numChannels = std::min(buffer.getNumChannels(), MAX_CHANNELS);
 
-            for (int i = 0; i < buffer.getNumSamples(); ++i)
-            {
-                float dry = samples[i];
-                float wet = processDistortion(samples[i] * drive);
-                samples[i] = dry * (1.0f - mix) + wet * mix;
-            }
+        // Shaper and order are resolved once per block; the sample loop is branch-light
+        switch (type)
+        {
+            case Type::SoftClip: processWith(Waveshapers::SoftClip{}, buffer, numChannels); break;
+            case Type::HardClip: processWith(Waveshapers::HardClip{}, buffer, numChannels); break;
+            case Type::Tube:     processWith(Waveshapers::Tube{}, buffer, numChannels); break;
+            case Type::Foldback: processWith(Waveshapers::Foldback{}, buffer, numChannels); break;
+            case Type::Bitcrush: processWith(bitcrusher, buffer, numChannels); break;
         }
     }
 
-    void reset() override {}
+    void reset() override
+    {
+        for (auto& s : state)
+            s = ChannelState{};
+    }
 
     juce::String getName() const override { return "Distortion"; }
 
     void setType(Type t) { type = t; }
     void setDrive(float d) { drive = juce::jlimit(1.0f, 100.0f, d); }
-    void setBitDepth(int bits) { bitDepth = juce::jlimit(1, 16, bits); }
+    void setAntialiasing(Antialiasing mode) { antialiasing = mode; }
+
+    void setBitDepth(int bits)
+    {
+        const int newBits = juce::jlimit(1, 16, bits);
+        if (newBits != bitDepth)
+        {
+            bitDepth = newBits;
+            bitcrusher.setBitDepth(bitDepth);  // Step computed here, not per sample
+        }
+    }
 
 private:
-    float processDistortion(float x) const
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr double ADAA_TOLERANCE = 1.0e-5;
+
+    // Previous inputs and cached antiderivative terms, per channel
+    struct ChannelState
     {
-        switch (type)
+        double x1 = 0.0, x2 = 0.0;   // Previous driven inputs
+        double F1x1 = 0.0;           // F1(x1) for first order
+        double F2x1 = 0.0;           // F2(x1) for second order
+        double D1prev = 0.0;         // First divided difference of F2 over (x2, x1)
+        float dry1 = 0.0f;           // Previous dry input (latency-matched dry path)
+    };
+
+    template <typename Shaper>
+    void processWith(const Shaper& shaper, juce::AudioBuffer<float>& buffer, int numChannels)
+    {
+        // Re-derive the cached antiderivative terms from the previous inputs, so
+        // changing curve or order between blocks stays continuous
+        for (auto& s : state)
         {
-            case Type::SoftClip:
-                return std::tanh(x);
+            s.F1x1 = shaper.F1(s.x1);
+            s.F2x1 = shaper.F2(s.x1);
+            s.D1prev = firstDifference(shaper, s.x1, s.x2, s.F2x1, shaper.F2(s.x2));
+        }
 
-            case Type::HardClip:
-                return juce::jlimit(-1.0f, 1.0f, x);
+        switch (antialiasing)
+        {
+            case Antialiasing::Off:         processNaive(shaper, buffer, numChannels); break;
+            case Antialiasing::FirstOrder:  processFirstOrder(shaper, buffer, numChannels); break;
+            case Antialiasing::SecondOrder: processSecondOrder(shaper, buffer, numChannels); break;
+        }
+    }
+
+    template <typename Shaper>
+    void processNaive(const Shaper& shaper, juce::AudioBuffer<float>& buffer, int numChannels)
+    {
+        const double gain = drive;
+        const float wetMix = mix, dryMix = 1.0f - mix;
 
-            case Type::Tube:
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* samples = buffer.getWritePointer(ch);
+            auto& s = state[static_cast<size_t>(ch)];
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
             {
-                // Asymmetric soft clipping for tube warmth
-                if (x > 0)
-                    return 1.0f - std::exp(-x);
-                else
-                    return -1.0f + std::exp(x);
+                const float in = samples[i];
+                const double x0 = in * gain;
+                samples[i] = in * dryMix + static_cast<float>(shaper.f(x0)) * wetMix;
+                s.x2 = s.x1;
+                s.x1 = x0;
+                s.dry1 = in;
             }
+        }
+    }
+
+    template <typename Shaper>
+    void processFirstOrder(const Shaper& shaper, juce::AudioBuffer<float>& buffer, int numChannels)
+    {
+        const double gain = drive;
+        const float wetMix = mix, dryMix = 1.0f - mix;
 
-            case Type::Foldback:
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* samples = buffer.getWritePointer(ch);
+            auto& s = state[static_cast<size_t>(ch)];
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
             {
-                // Wavefolder
-                while (x > 1.0f || x < -1.0f)
-                {
-                    if (x > 1.0f)
-                        x = 2.0f - x;
-                    else if (x < -1.0f)
-                        x = -2.0f - x;
-                }
-                return x;
+                const float in = samples[i];
+                const double x0 = in * gain;
+                const double F1x0 = shaper.F1(x0);
+                const double dx = x0 - s.x1;
+
+                // Ill-conditioned when consecutive inputs nearly match: use the midpoint
+                const double wet = std::abs(dx) > ADAA_TOLERANCE ? (F1x0 - s.F1x1) / dx
+                                                                 : shaper.f(0.5 * (x0 + s.x1));
+
+                // ADAA1 delays the wet path by half a sample; match it on the dry path
+                const float dry = 0.5f * (in + s.dry1);
+                samples[i] = dry * dryMix + static_cast<float>(wet) * wetMix;
+
+                s.x2 = s.x1;
+                s.x1 = x0;
+                s.F1x1 = F1x0;
+                s.dry1 = in;
             }
+        }
+    }
 
-            case Type::Bitcrush:
+    template <typename Shaper>
+    void processSecondOrder(const Shaper& shaper, juce::AudioBuffer<float>& buffer, int numChannels)
+    {
+        const double gain = drive;
+        const float wetMix = mix, dryMix = 1.0f - mix;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* samples = buffer.getWritePointer(ch);
+            auto& s = state[static_cast<size_t>(ch)];
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
             {
-                float levels = std::pow(2.0f, static_cast<float>(bitDepth));
-                return std::round(x * levels) / levels;
-            }
+                const float in = samples[i];
+                const double x0 = in * gain;
+                const double F2x0 = shaper.F2(x0);
+                const double D1 = firstDifference(shaper, x0, s.x1, F2x0, s.F2x1);
+                const double dx2 = x0 - s.x2;
+
+                double wet;
+                if (std::abs(dx2) > ADAA_TOLERANCE)
+                {
+                    wet = 2.0 * (D1 - s.D1prev) / dx2;
+                }
+                else
+                {
+                    // x0 ~= x2: expand around their mean instead
+                    const double xBar = 0.5 * (x0 + s.x2);
+                    const double delta = xBar - s.x1;
+                    wet = std::abs(delta) > ADAA_TOLERANCE
+                        ? (2.0 / delta) * (shaper.F1(xBar) + (s.F2x1 - shaper.F2(xBar)) / delta)
+                        : shaper.f(0.5 * (xBar + s.x1));
+                }
 
-            default:
-                return x;
+                // ADAA2 delays the wet path by one sample
+                samples[i] = s.dry1 * dryMix + static_cast<float>(wet) * wetMix;
+
+                s.x2 = s.x1;
+                s.x1 = x0;
+                s.F2x1 = F2x0;
+                s.D1prev = D1;
+                s.dry1 = in;
+            }
         }
     }
 
+    template <typename Shaper>
+    static double firstDifference(const Shaper& shaper, double x0, double x1, double F2x0, double F2x1)
+    {
+        const double dx = x0 - x1;
+        return std::abs(dx) > ADAA_TOLERANCE ? (F2x0 - F2x1) / dx
+                                             : shaper.F1(0.5 * (x0 + x1));
+    }
+
+    std::array<ChannelState, MAX_CHANNELS> state{};
+
+    Waveshapers::Bitcrush bitcrusher;
     Type type = Type::SoftClip;
+    Antialiasing antialiasing = Antialiasing::FirstOrder;
     float drive = 1.0f;
     int bitDepth = 8;
 };
@@ -522,7 +798,7 @@ private:
 /**
  * Compressor
  */
-class CompressorEffect : public Effect
+class CompressorEffect final : public Effect
 {
 public:
     void prepare(double sr, int blockSize) override
@@ -579,8 +855,10 @@ private:
 
 /**
  * EQ (3-band parametric)
+ * Coefficients are designed in place and only for bands whose parameters
+ * changed, then interpolated across the next block. Safe to automate every block.
  */
-class EQEffect : public Effect
+class EQEffect final : public Effect
 {
 public:
     void prepare(double sr, int blockSize) override
@@ -588,16 +866,13 @@ public:
         sampleRate = sr;
         samplesPerBlock = blockSize;
 
-        juce::dsp::ProcessSpec spec;
-        spec.sampleRate = sr;
-        spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
-        spec.numChannels = 2;
-
-        lowShelf.prepare(spec);
-        midPeak.prepare(spec);
-        highShelf.prepare(spec);
+        // Jump straight to the current settings; ramping starts from here
+        computeCoefficients();
+        for (int band = 0; band < NUM_BANDS; ++band)
+            cascade.setCoefficients(band, bandCoefficients[static_cast<size_t>(band)]);
 
-        updateFilters();
+        dirtyBands = 0;
+        cascade.reset();
     }
 
     void process(juce::AudioBuffer<float>& buffer) override
@@ -605,130 +880,563 @@ public:
         if (!enabled)
             return;
 
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
+        // Only bands whose parameters actually moved are redesigned
+        if (dirtyBands != 0)
+        {
+            computeCoefficients();
+            for (int band = 0; band < NUM_BANDS; ++band)
+            {
+                if (dirtyBands & (1u << band))
+                    cascade.setTargetCoefficients(band, bandCoefficients[static_cast<size_t>(band)]);
+            }
+            dirtyBands = 0;
+        }
 
-        lowShelf.process(context);
-        midPeak.process(context);
-        highShelf.process(context);
+        processStereoOrMono(buffer, [this](float* l, float* r, int n) { cascade.process(l, r, n); });
     }
 
     void reset() override
     {
-        lowShelf.reset();
-        midPeak.reset();
-        highShelf.reset();
+        cascade.reset();
     }
 
     juce::String getName() const override { return "EQ"; }
 
-    void setLowGain(float db) { lowGain = db; updateFilters(); }
-    void setLowFreq(float hz) { lowFreq = hz; updateFilters(); }
-    void setMidGain(float db) { midGain = db; updateFilters(); }
-    void setMidFreq(float hz) { midFreq = hz; updateFilters(); }
-    void setMidQ(float q) { midQ = q; updateFilters(); }
-    void setHighGain(float db) { highGain = db; updateFilters(); }
-    void setHighFreq(float hz) { highFreq = hz; updateFilters(); }
+    void setLowGain(float db) { update(lowGain, db, LowBand); }
+    void setLowFreq(float hz) { update(lowFreq, hz, LowBand); }
+    void setMidGain(float db) { update(midGain, db, MidBand); }
+    void setMidFreq(float hz) { update(midFreq, hz, MidBand); }
+    void setMidQ(float q) { update(midQ, q, MidBand); }
+    void setHighGain(float db) { update(highGain, db, HighBand); }
+    void setHighFreq(float hz) { update(highFreq, hz, HighBand); }
 
 private:
-    void updateFilters()
-    {
-        *lowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-            sampleRate, lowFreq, 0.707f, juce::Decibels::decibelsToGain(lowGain));
+    enum Band { LowBand, MidBand, HighBand, NUM_BANDS };
 
-        *midPeak.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            sampleRate, midFreq, midQ, juce::Decibels::decibelsToGain(midGain));
+    // Change detection: setters are called every block, most with unchanged values
+    void update(float& param, float value, Band band)
+    {
+        if (param != value)
+        {
+            param = value;
+            dirtyBands |= 1u << band;
+        }
+    }
 
-        *highShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-            sampleRate, highFreq, 0.707f, juce::Decibels::decibelsToGain(highGain));
+    void computeCoefficients()
+    {
+        bandCoefficients[LowBand].makeLowShelf(sampleRate, lowFreq, 0.707f, juce::Decibels::decibelsToGain(lowGain));
+        bandCoefficients[MidBand].makePeak(sampleRate, midFreq, midQ, juce::Decibels::decibelsToGain(midGain));
+        bandCoefficients[HighBand].makeHighShelf(sampleRate, highFreq, 0.707f, juce::Decibels::decibelsToGain(highGain));
     }
 
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>> lowShelf, midPeak, highShelf;
+    StereoBiquadCascade<NUM_BANDS> cascade;
+    std::array<BiquadCoefficients, NUM_BANDS> bandCoefficients{};
+    unsigned dirtyBands = 0;
 
     float lowGain = 0.0f, lowFreq = 100.0f;
     float midGain = 0.0f, midFreq = 1000.0f, midQ = 1.0f;
     float highGain = 0.0f, highFreq = 8000.0f;
 };
 
+/**
+ * Convolution reverb
+ * IRs are decoded, resampled to the processing rate and partitioned on a
+ * background loader thread, then handed to the convolver without locking.
+ */
+class ConvolutionEffect final : public Effect
+{
+public:
+    static constexpr double MAX_IR_SECONDS = 10.0;
+
+    ConvolutionEffect() : loader(*this) {}
+
+    ~ConvolutionEffect() override
+    {
+        loader.stopThread(4000);
+    }
+
+    void prepare(double sr, int blockSize) override
+    {
+        const bool rateChanged = (sr != sampleRate);
+        sampleRate = sr;
+        samplesPerBlock = blockSize;
+
+        convolver.prepare();
+
+        if (!loader.isThreadRunning())
+            loader.startThread(juce::Thread::Priority::background);
+
+        // The loaded IR was resampled for the old rate
+        if (rateChanged)
+            loader.requestReload(sr);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        if (!enabled)
+            return;
+
+        processStereoOrMono(buffer, [this](float* l, float* r, int n) { convolver.process(l, r, n, mix); });
+    }
+
+    void reset() override
+    {
+        convolver.reset();
+    }
+
+    juce::String getName() const override { return "Convolution"; }
+
+    double getTailLengthSeconds() const override
+    {
+        return convolver.getTailLengthSamples() / sampleRate;
+    }
+
+    // Asynchronous: the new IR takes over once it has been decoded and partitioned
+    void loadImpulseResponse(const juce::File& file)
+    {
+        loader.request(file, sampleRate);
+    }
+
+    bool hasImpulseResponse() const { return convolver.hasKernel(); }
+    uint32_t getMissedDeadlineCount() const { return convolver.getMissedDeadlineCount(); }
+
+private:
+    /** Background thread that builds kernels and frees retired ones */
+    class Loader : public juce::Thread
+    {
+    public:
+        explicit Loader(ConvolutionEffect& o) : juce::Thread("Convolution IR loader"), owner(o) {}
+
+        void request(const juce::File& file, double rate)
+        {
+            {
+                const juce::ScopedLock sl(lock);
+                requestedFile = file;
+                requestedRate = rate;
+                targetRate = rate;
+                hasRequest = true;
+            }
+            notify();
+        }
+
+        /**
+         * The processing rate changed: rebuild for it. Covers an IR that is
+         * loaded, queued (e.g. restored before prepareToPlay) or being built.
+         */
+        void requestReload(double rate)
+        {
+            {
+                const juce::ScopedLock sl(lock);
+                targetRate = rate;
+
+                if (hasRequest)
+                {
+                    requestedRate = rate;
+                    return;
+                }
+
+                // One being built is re-queued by run() when it sees the new rate
+                if (buildingFile != juce::File() || currentFile == juce::File())
+                    return;
+
+                requestedFile = currentFile;
+                requestedRate = rate;
+                hasRequest = true;
+            }
+            notify();
+        }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                wait(500);
+
+                // Swapped-out kernels are freed here, never on the audio thread
+                owner.convolver.collectGarbage();
+
+                juce::File file;
+                double rate = 0.0;
+                {
+                    const juce::ScopedLock sl(lock);
+                    if (!hasRequest)
+                        continue;
+                    file = requestedFile;
+                    rate = requestedRate;
+                    hasRequest = false;
+                    buildingFile = file;
+                }
+
+                auto kernel = buildKernel(file, rate);
+
+                const juce::ScopedLock sl(lock);
+                buildingFile = juce::File();
+
+                // The rate changed while this was building: build it again rather than install it
+                if (rate != targetRate)
+                {
+                    if (!hasRequest)
+                    {
+                        requestedFile = file;
+                        requestedRate = targetRate;
+                        hasRequest = true;
+                        notify();
+                    }
+                    continue;
+                }
+
+                if (kernel != nullptr)
+                {
+                    owner.convolver.submitKernel(std::move(kernel));
+                    currentFile = file;
+                }
+            }
+        }
+
+    private:
+        static std::unique_ptr<PartitionedConvolver::Kernel> buildKernel(const juce::File& file, double targetRate)
+        {
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+            if (reader == nullptr || reader->sampleRate <= 0.0 || targetRate <= 0.0)
+                return nullptr;
+
+            const int sourceLength = static_cast<int>(std::min<juce::int64>(
+                reader->lengthInSamples, static_cast<juce::int64>(MAX_IR_SECONDS * reader->sampleRate)));
+            const int numChannels = static_cast<int>(std::min<unsigned int>(2u, reader->numChannels));
+            if (sourceLength <= 0 || numChannels <= 0)
+                return nullptr;
+
+            juce::AudioBuffer<float> source(numChannels, sourceLength);
+            reader->read(&source, 0, sourceLength, 0, true, numChannels > 1);
+
+            // Band-limited resample to the processing rate
+            const double ratio = reader->sampleRate / targetRate;
+            const int length = static_cast<int>(std::ceil(sourceLength / ratio));
+            juce::AudioBuffer<float> ir(numChannels, length);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                if (ratio == 1.0)
+                {
+                    ir.copyFrom(ch, 0, source, ch, 0, sourceLength);
+                }
+                else
+                {
+                    juce::WindowedSincInterpolator interpolator;
+                    interpolator.process(ratio, source.getReadPointer(ch), ir.getWritePointer(ch), length,
+                                         sourceLength, 0);
+                }
+            }
+
+            // Unit energy on the loudest channel keeps wet level comparable to dry
+            float maxEnergy = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* d = ir.getReadPointer(ch);
+                float energy = 0.0f;
+                for (int i = 0; i < length; ++i)
+                    energy += d[i] * d[i];
+                maxEnergy = std::max(maxEnergy, energy);
+            }
+            if (maxEnergy > 0.0f)
+                ir.applyGain(1.0f / std::sqrt(maxEnergy));
+
+            return PartitionedConvolver::createKernel(ir);
+        }
+
+        ConvolutionEffect& owner;
+        juce::CriticalSection lock;   // Loader and message thread only
+        juce::File requestedFile, currentFile;
+        juce::File buildingFile;        // Between taking a request and installing its kernel
+        double requestedRate = 0.0;
+        double targetRate = 0.0;        // The rate the effect runs at now
+        bool hasRequest = false;
+    };
+
+    PartitionedConvolver convolver;
+    Loader loader;
+};
+
+/**
+ * Master limiter - true-peak lookahead brickwall at the very end of the rack
+ * Lives outside the reorderable chain; adds getLatencySamples() of delay while enabled.
+ */
+class LimiterEffect final : public Effect
+{
+public:
+    void prepare(double sr, int blockSize) override
+    {
+        sampleRate = sr;
+        samplesPerBlock = blockSize;
+        limiter.prepare(sr);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        if (!enabled)
+            return;
+
+        processStereoOrMono(buffer, [this](float* l, float* r, int n) { limiter.process(l, r, n); });
+    }
+
+    void reset() override
+    {
+        limiter.reset();
+    }
+
+    juce::String getName() const override { return "Limiter"; }
+
+    // The delay line still holds audio after the input stops
+    double getTailLengthSeconds() const override { return limiter.getLatencySamples() / sampleRate; }
+
+    // Use instead of setEnabled: switching on starts from a clean delay line
+    // rather than replaying whatever was left in it
+    void setActive(bool shouldBeActive)
+    {
+        if (shouldBeActive && !enabled)
+            limiter.reset();
+        setEnabled(shouldBeActive);
+    }
+
+    void setCeiling(float db) { limiter.setCeiling(db); }
+    void setRelease(float ms) { limiter.setRelease(ms); }
+
+    void setLookahead(float ms)
+    {
+        if (ms != lookaheadMs)
+        {
+            lookaheadMs = ms;
+            limiter.setLookahead(ms);
+        }
+    }
+
+    int getLatencySamples() const { return enabled ? limiter.getLatencySamples() : 0; }
+    float getGainReductionDb() const { return limiter.getGainReductionDb(); }
+
+private:
+    LookaheadLimiter limiter;
+    float lookaheadMs = 5.0f;
+};
+
 /**
  * FX Rack - manages a chain of effects
+ * - Every effect is a member of one tuple, so the instances sit contiguously
+ *   in the rack and typed access (get<T>) is resolved at compile time
+ * - Processing order is a permutation of slot indices packed into one atomic
+ *   word: reordering swaps the word and never moves an effect or allocates
+ * - The audio thread dispatches each slot through a table of concrete
+ *   per-slot functions, not through Effect's virtual process()
  */
 class FXRack
 {
 public:
+    // Default processing order
+    using Effects = std::tuple<DistortionEffect,
+                               EQEffect,
+                               CompressorEffect,
+                               ChorusEffect,
+                               FlangerEffect,
+                               DelayEffect,
+                               ReverbEffect,
+                               ConvolutionEffect>;
+
+    static constexpr int NUM_EFFECTS = static_cast<int>(std::tuple_size_v<Effects>);
+    using Order = std::array<uint8_t, NUM_EFFECTS>;
+
+    static_assert(NUM_EFFECTS <= 8, "Order is packed one byte per slot into a 64-bit word");
+
     FXRack()
     {
-        // Add default effects in order
-        effects.push_back(std::make_unique<DistortionEffect>());
-        effects.push_back(std::make_unique<EQEffect>());
-        effects.push_back(std::make_unique<CompressorEffect>());
-        effects.push_back(std::make_unique<ChorusEffect>());
-        effects.push_back(std::make_unique<FlangerEffect>());
-        effects.push_back(std::make_unique<DelayEffect>());
-        effects.push_back(std::make_unique<ReverbEffect>());
+        slots = std::apply([](auto&... fx) { return std::array<Effect*, NUM_EFFECTS> { &fx... }; }, effects);
 
         // Disable all by default
-        for (auto& fx : effects)
+        for (auto* fx : slots)
             fx->setEnabled(false);
+        limiter.setEnabled(false);
+
+        Order initial{};
+        for (int i = 0; i < NUM_EFFECTS; ++i)
+            initial[static_cast<size_t>(i)] = static_cast<uint8_t>(i);
+        packedOrder.store(pack(initial), std::memory_order_release);
     }
 
     void prepare(double sampleRate, int samplesPerBlock)
     {
-        for (auto& fx : effects)
+        for (auto* fx : slots)
             fx->prepare(sampleRate, samplesPerBlock);
+        limiter.prepare(sampleRate, samplesPerBlock);
+    }
+
+    // inputSilent: the buffer holds silence (nothing rendered this block).
+    // Effects whose tails have run out are then skipped - their output would
+    // be silence too. Once any effect rings on, everything after it is live.
+    void process(juce::AudioBuffer<float>& buffer, bool inputSilent = false)
+    {
+        const Order order = unpack(packedOrder.load(std::memory_order_acquire));
+        bool silent = inputSilent;
+
+        for (const auto slot : order)
+            getSlotProcessor(slot)(*this, buffer, silent);
+
+        processWithTail(limiter, buffer, silent);
+    }
+
+    void reset()
+    {
+        for (auto* fx : slots)
+            fx->reset();
+        limiter.reset();
+    }
+
+    // True when every enabled effect has rung out since its input last went silent
+    bool isIdle() const
+    {
+        for (const auto* fx : slots)
+        {
+            if (fx->isEnabled() && fx->isTailActive())
+                return false;
+        }
+        return !(limiter.isEnabled() && limiter.isTailActive());
     }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    // Worst-case tail of the enabled chain (effects are in series, so tails add)
+    double getTailLengthSeconds() const
     {
-        for (auto& fx : effects)
+        double total = 0.0;
+        for (const auto* fx : slots)
         {
             if (fx->isEnabled())
-                fx->process(buffer);
+                total += fx->getTailLengthSeconds();
         }
+        if (limiter.isEnabled())
+            total += limiter.getTailLengthSeconds();
+        return total;
     }
 
-    void reset()
+    // Latency the host must compensate (only the limiter's lookahead)
+    int getLatencySamples() const { return limiter.getLatencySamples(); }
+
+    // Typed handles: resolved at compile time, never null
+    template <typename T>
+    T& get()
     {
-        for (auto& fx : effects)
-            fx->reset();
+        if constexpr (std::is_same_v<T, LimiterEffect>)
+            return limiter;
+        else
+            return std::get<T>(effects);
     }
 
+    template <typename T>
+    T* getEffect() { return &get<T>(); }
+
+    // Effect at a position in the current processing order
     Effect* getEffect(int index)
     {
-        if (index >= 0 && index < static_cast<int>(effects.size()))
-            return effects[index].get();
+        if (index >= 0 && index < NUM_EFFECTS)
+            return slots[getOrder()[static_cast<size_t>(index)]];
         return nullptr;
     }
 
-    template<typename T>
-    T* getEffect()
+    int getNumEffects() const { return NUM_EFFECTS; }
+
+    Order getOrder() const { return unpack(packedOrder.load(std::memory_order_acquire)); }
+
+    // Install a new processing order; ignored unless it is a permutation of the slots
+    void setOrder(const Order& newOrder)
     {
-        for (auto& fx : effects)
+        std::array<bool, NUM_EFFECTS> seen{};
+        for (const auto slot : newOrder)
         {
-            if (auto* cast = dynamic_cast<T*>(fx.get()))
-                return cast;
+            if (slot >= NUM_EFFECTS || seen[slot])
+                return;
+            seen[slot] = true;
         }
-        return nullptr;
-    }
 
-    int getNumEffects() const { return static_cast<int>(effects.size()); }
+        packedOrder.store(pack(newOrder), std::memory_order_release);
+    }
 
-    // Reorder effects
+    // Reorder effects (positions in the processing order)
     void moveEffect(int fromIndex, int toIndex)
     {
-        if (fromIndex < 0 || fromIndex >= static_cast<int>(effects.size()))
+        if (fromIndex < 0 || fromIndex >= NUM_EFFECTS)
             return;
-        if (toIndex < 0 || toIndex >= static_cast<int>(effects.size()))
+        if (toIndex < 0 || toIndex >= NUM_EFFECTS)
             return;
 
-        auto effect = std::move(effects[fromIndex]);
-        effects.erase(effects.begin() + fromIndex);
-        effects.insert(effects.begin() + toIndex, std::move(effect));
+        auto order = getOrder();
+        const auto first = order.begin();
+        if (fromIndex < toIndex)
+            std::rotate(first + fromIndex, first + fromIndex + 1, first + toIndex + 1);
+        else
+            std::rotate(first + toIndex, first + fromIndex, first + fromIndex + 1);
+
+        setOrder(order);
     }
 
 private:
-    std::vector<std::unique_ptr<Effect>> effects;
+    using SlotProcessor = void (*)(FXRack&, juce::AudioBuffer<float>&, bool&);
+
+    template <size_t Slot>
+    static void processSlot(FXRack& rack, juce::AudioBuffer<float>& buffer, bool& silent)
+    {
+        processWithTail(std::get<Slot>(rack.effects), buffer, silent);
+    }
+
+    template <typename EffectType>
+    static void processWithTail(EffectType& fx, juce::AudioBuffer<float>& buffer, bool& silent)
+    {
+        if (!fx.isEnabled())
+            return;
+
+        if (!silent)
+        {
+            fx.restartTail();
+            fx.process(buffer);
+        }
+        else if (fx.isTailActive())
+        {
+            fx.process(buffer);
+            fx.consumeTail(buffer.getNumSamples());
+            silent = false;
+        }
+    }
+
+    template <size_t... Slots>
+    static constexpr std::array<SlotProcessor, NUM_EFFECTS> makeSlotProcessors(std::index_sequence<Slots...>)
+    {
+        return { &processSlot<Slots>... };
+    }
+
+    static SlotProcessor getSlotProcessor(size_t slot)
+    {
+        static constexpr auto processors = makeSlotProcessors(std::make_index_sequence<NUM_EFFECTS>{});
+        return processors[slot];
+    }
+
+    static uint64_t pack(const Order& order)
+    {
+        uint64_t word = 0;
+        for (int i = 0; i < NUM_EFFECTS; ++i)
+            word |= static_cast<uint64_t>(order[static_cast<size_t>(i)]) << (8 * i);
+        return word;
+    }
+
+    static Order unpack(uint64_t word)
+    {
+        Order order{};
+        for (int i = 0; i < NUM_EFFECTS; ++i)
+            order[static_cast<size_t>(i)] = static_cast<uint8_t>((word >> (8 * i)) & 0xff);
+        return order;
+    }
+
+    alignas(64) Effects effects;
+    LimiterEffect limiter;
+    std::array<Effect*, NUM_EFFECTS> slots{};
+    std::atomic<uint64_t> packedOrder{0};
 };
 
 } // namespace DSP
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Stereo lookahead brickwall limiter with true-peak detection
+ * - Detector: 4x polyphase interpolation estimates inter-sample peaks; the
+ *   per-chunk FIR is a fixed-size dot product the compiler vectorises
+ * - Sliding-window maximum over the lookahead via a monotonic deque
+ *   (amortised O(1) per sample, preallocated ring)
+ * - Gain: instant attack / one-pole release, then a moving average the
+ *   length of the lookahead so reduction ramps in smoothly and is fully
+ *   applied when the peak reaches the output
+ * - Audio is delayed by the lookahead plus the detector's group delay;
+ *   getLatencySamples() reports exactly that
+ */
+class LookaheadLimiter
+{
+public:
+    static constexpr int NUM_CHANNELS = 2;
+    static constexpr float MAX_LOOKAHEAD_MS = 10.0f;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        maxWindow = std::max(1, static_cast<int>(std::ceil(MAX_LOOKAHEAD_MS * 0.001 * sampleRate)));
+
+        const int delaySize = juce::nextPowerOfTwo(maxWindow + DETECTOR_DELAY + 1);
+        for (auto& line : delayLines)
+            line.assign(static_cast<size_t>(delaySize), 0.0f);
+        delayMask = delaySize - 1;
+
+        const int ringSize = juce::nextPowerOfTwo(maxWindow + 1);
+        dequeIndex.assign(static_cast<size_t>(ringSize), 0);
+        dequeValue.assign(static_cast<size_t>(ringSize), 0.0f);
+        dequeMask = ringSize - 1;
+        boxRing.assign(static_cast<size_t>(maxWindow), 1.0f);
+
+        designInterpolator();
+        updateRelease();
+        window = lookaheadToWindow(lookaheadMs);
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& line : delayLines)
+            std::fill(line.begin(), line.end(), 0.0f);
+        for (auto& h : history)
+            h.fill(0.0f);
+
+        writePos = 0;
+        sampleIndex = 0;
+        dequeHead = dequeTail = 0;
+        envelope = 1.0f;
+        resetBox();
+    }
+
+    void setCeiling(float db) { ceiling = juce::Decibels::decibelsToGain(juce::jlimit(-24.0f, 0.0f, db)); }
+
+    void setRelease(float ms)
+    {
+        if (ms != releaseMs)
+        {
+            releaseMs = juce::jmax(1.0f, ms);
+            updateRelease();
+        }
+    }
+
+    // Takes effect at the next block; changes the reported latency
+    void setLookahead(float ms)
+    {
+        lookaheadMs = juce::jlimit(0.1f, MAX_LOOKAHEAD_MS, ms);
+        pendingWindow = lookaheadToWindow(lookaheadMs);
+    }
+
+    // Latency for the lookahead that will be in effect from the next block
+    int getLatencySamples() const { return (pendingWindow > 0 ? pendingWindow : window) - 1 + DETECTOR_DELAY; }
+
+    // Current gain reduction in dB (<= 0)
+    float getGainReductionDb() const { return juce::Decibels::gainToDecibels(lastGain, -60.0f); }
+
+    void process(float* left, float* right, int numSamples)
+    {
+        if (delayLines[0].empty())
+            return;
+
+        if (pendingWindow > 0)
+        {
+            // The delay itself changes length; restart the gain smoothing around it
+            window = pendingWindow;
+            pendingWindow = 0;
+            dequeHead = dequeTail = 0;
+            resetBox();
+        }
+
+        std::array<float*, NUM_CHANNELS> io { left, right };
+
+        for (int start = 0; start < numSamples; start += CHUNK)
+        {
+            const int n = std::min(CHUNK, numSamples - start);
+            detectPeaks(io, start, n);
+
+            const int delay = window - 1 + DETECTOR_DELAY;
+            const float invWindow = 1.0f / static_cast<float>(window);
+
+            for (int i = 0; i < n; ++i)
+            {
+                // Lowest gain any peak in the lookahead window asks for
+                const float windowPeak = pushPeak(peaks[static_cast<size_t>(i)]);
+                const float target = windowPeak > ceiling ? ceiling / windowPeak : 1.0f;
+
+                envelope = target < envelope ? target : target + (envelope - target) * releaseCoeff;
+
+                // Moving average over the window: the ramp bottoms out as the peak arrives
+                boxSum += static_cast<double>(envelope) - boxRing[static_cast<size_t>(boxPos)];
+                boxRing[static_cast<size_t>(boxPos)] = envelope;
+                if (++boxPos == window)
+                    boxPos = 0;
+                const float gain = std::min(1.0f, static_cast<float>(boxSum) * invWindow);
+
+                const int readPos = (writePos - delay) & delayMask;
+                for (int c = 0; c < NUM_CHANNELS; ++c)
+                {
+                    auto& line = delayLines[static_cast<size_t>(c)];
+                    float& sample = io[static_cast<size_t>(c)][start + i];
+                    line[static_cast<size_t>(writePos)] = sample;
+                    sample = line[static_cast<size_t>(readPos)] * gain;
+                }
+
+                writePos = (writePos + 1) & delayMask;
+                ++sampleIndex;
+                lastGain = gain;
+            }
+        }
+    }
+
+private:
+    static constexpr int OVERSAMPLING = 4;
+    static constexpr int TAPS = 8;                     // Per interpolation phase
+    static constexpr int DETECTOR_DELAY = TAPS / 2;    // Interpolated points sit this far back
+    static constexpr int CHUNK = 64;
+
+    int lookaheadToWindow(float ms) const
+    {
+        return juce::jlimit(1, maxWindow, juce::roundToInt(ms * 0.001 * sampleRate));
+    }
+
+    void updateRelease()
+    {
+        releaseCoeff = std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
+    }
+
+    // Box filter restarts settled at the current envelope
+    void resetBox()
+    {
+        std::fill(boxRing.begin(), boxRing.end(), envelope);
+        boxSum = static_cast<double>(envelope) * window;
+        boxPos = 0;
+    }
+
+    // Hann-windowed sinc fractional-delay taps for the three in-between phases
+    void designInterpolator()
+    {
+        for (int p = 1; p < OVERSAMPLING; ++p)
+        {
+            const double frac = static_cast<double>(p) / OVERSAMPLING;
+            auto& c = coefficients[static_cast<size_t>(p - 1)];
+            double sum = 0.0;
+
+            for (int j = 0; j < TAPS; ++j)
+            {
+                // Tap j holds x[n - (TAPS - 1) + j]; the target point is n - DETECTOR_DELAY + frac
+                const double u = static_cast<double>(j - (TAPS - 1) + DETECTOR_DELAY) - frac;
+                const double sinc = std::abs(u) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * u) / (juce::MathConstants<double>::pi * u);
+                const double w = 0.5 + 0.5 * std::cos(juce::MathConstants<double>::pi * u / (DETECTOR_DELAY + 0.5));
+                c[static_cast<size_t>(j)] = static_cast<float>(sinc * w);
+                sum += sinc * w;
+            }
+
+            for (auto& v : c)
+                v = static_cast<float>(v / sum);
+        }
+    }
+
+    // Per-sample linked true-peak estimate (delayed by DETECTOR_DELAY) into `peaks`
+    void detectPeaks(const std::array<float*, NUM_CHANNELS>& io, int start, int n)
+    {
+        std::fill(peaks.begin(), peaks.begin() + n, 0.0f);
+
+        for (int c = 0; c < NUM_CHANNELS; ++c)
+        {
+            auto& h = history[static_cast<size_t>(c)];
+            std::copy(io[static_cast<size_t>(c)] + start, io[static_cast<size_t>(c)] + start + n, h.begin() + (TAPS - 1));
+
+            for (int i = 0; i < n; ++i)
+            {
+                const float* x = h.data() + i;
+                float peak = std::abs(x[TAPS - 1 - DETECTOR_DELAY]);
+
+                for (const auto& coeffs : coefficients)
+                {
+                    float acc = 0.0f;
+                    for (int j = 0; j < TAPS; ++j)
+                        acc += coeffs[static_cast<size_t>(j)] * x[j];
+                    peak = std::max(peak, std::abs(acc));
+                }
+
+                peaks[static_cast<size_t>(i)] = std::max(peaks[static_cast<size_t>(i)], peak);
+            }
+
+            // Keep the last TAPS - 1 inputs for the next chunk
+            std::copy(h.begin() + n, h.begin() + n + (TAPS - 1), h.begin());
+        }
+    }
+
+    // Monotonic deque: returns the maximum of the last `window` detector values
+    float pushPeak(float value)
+    {
+        while (dequeTail != dequeHead && dequeValue[static_cast<size_t>((dequeTail - 1) & dequeMask)] <= value)
+            --dequeTail;
+
+        dequeIndex[static_cast<size_t>(dequeTail & dequeMask)] = sampleIndex;
+        dequeValue[static_cast<size_t>(dequeTail & dequeMask)] = value;
+        ++dequeTail;
+
+        while (dequeIndex[static_cast<size_t>(dequeHead & dequeMask)] <= sampleIndex - window)
+            ++dequeHead;
+
+        return dequeValue[static_cast<size_t>(dequeHead & dequeMask)];
+    }
+
+    double sampleRate = 44100.0;
+
+    std::array<std::vector<float>, NUM_CHANNELS> delayLines;
+    int delayMask = 0;
+    int writePos = 0;
+
+    std::array<std::array<float, CHUNK + TAPS - 1>, NUM_CHANNELS> history{};
+    std::array<std::array<float, TAPS>, OVERSAMPLING - 1> coefficients{};
+    std::array<float, CHUNK> peaks{};
+
+    std::vector<juce::int64> dequeIndex;
+    std::vector<float> dequeValue;
+    juce::int64 dequeHead = 0, dequeTail = 0;
+    int dequeMask = 0;
+    juce::int64 sampleIndex = 0;
+
+    std::vector<float> boxRing;
+    double boxSum = 1.0;
+    int boxPos = 0;
+
+    int maxWindow = 1;
+    int window = 1;
+    int pendingWindow = 0;
+
+    float ceiling = 0.891251f;  // -1 dB
+    float lookaheadMs = 5.0f;
+    float releaseMs = 100.0f;
+    float releaseCoeff = 0.0f;
+    float envelope = 1.0f;
+    float lastGain = 1.0f;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Shared LFO wavetable
+ * One read-only sine table for every modulated effect instance; lookups are
+ * a linear interpolation between two entries instead of a std::sin call.
+ */
+class LFOTable
+{
+public:
+    static constexpr int SIZE = 1024;
+
+    static const LFOTable& sine()
+    {
+        static const LFOTable table;
+        return table;
+    }
+
+    // Phase in cycles, [0, 1)
+    float lookup(float phase) const
+    {
+        const float pos = phase * static_cast<float>(SIZE);
+        const int index = static_cast<int>(pos);
+        const float frac = pos - static_cast<float>(index);
+        const float a = values[static_cast<size_t>(index & (SIZE - 1))];
+        const float b = values[static_cast<size_t>((index & (SIZE - 1)) + 1)];
+        return a + (b - a) * frac;
+    }
+
+private:
+    LFOTable()
+    {
+        // One guard entry so the interpolator never needs to wrap
+        for (int i = 0; i <= SIZE; ++i)
+            values[static_cast<size_t>(i)] = static_cast<float>(
+                std::sin(juce::MathConstants<double>::twoPi * static_cast<double>(i) / SIZE));
+    }
+
+    std::array<float, SIZE + 1> values{};
+};
+
+/**
+ * Stereo multi-voice modulated delay line - the kernel behind chorus,
+ * flanger and ensemble
+ * - Each voice is a pair of lanes (L, R) reading a fractional tap from the
+ *   channel's line; lane state lives in aligned arrays like FDNReverb
+ * - LFOs are evaluated from the shared table once per CONTROL_INTERVAL and
+ *   the tap delays ramp linearly in between, so the sample loop holds no
+ *   transcendental calls
+ * - Voices are spread evenly in LFO phase; the right channel adds a fixed
+ *   stereo phase offset
+ * - Delay range (centre +/- depth) is clamped when parameters change, never
+ *   inside the loop
+ */
+class ModulatedDelay
+{
+public:
+    static constexpr int MAX_VOICES = 4;
+    static constexpr int NUM_LANES = MAX_VOICES * 2;
+    static constexpr int CONTROL_INTERVAL = 16;
+
+    void prepare(double newSampleRate, float maxDelayMs)
+    {
+        sampleRate = newSampleRate;
+
+        const int required = static_cast<int>(std::ceil(maxDelayMs * 0.001 * sampleRate)) + 2;
+        const int size = juce::nextPowerOfTwo(required);
+        for (auto& line : lines)
+            line.assign(static_cast<size_t>(size), 0.0f);
+        mask = size - 1;
+        maxDelaySamples = static_cast<float>(size - 2);
+
+        updateRange();
+        updateRate();
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& line : lines)
+            std::fill(line.begin(), line.end(), 0.0f);
+
+        writePos = 0;
+        phase = 0.0f;
+        delay.fill(centreSamples);
+    }
+
+    void setCentreDelay(float ms) { centreMs = ms; updateRange(); }
+    void setDepth(float ms) { depthMs = ms; updateRange(); }
+    void setRate(float hz) { rateHz = hz; updateRate(); }
+    void setFeedback(float fb) { feedback = juce::jlimit(-0.95f, 0.95f, fb); }
+    void setStereoPhase(float cycles) { stereoPhase = cycles; }
+
+    float getFeedback() const { return feedback; }
+    double getLongestDelaySeconds() const { return (centreSamples + depthSamples) / sampleRate; }
+
+    void setNumVoices(int voices)
+    {
+        numVoices = juce::jlimit(1, MAX_VOICES, voices);
+        // Uncorrelated taps add in power; feedback takes the mean so |fb| < 1 stays stable
+        wetNorm = 1.0f / std::sqrt(static_cast<float>(numVoices));
+        feedbackNorm = 1.0f / static_cast<float>(numVoices);
+    }
+
+    // In-place stereo processing: out = in * dryGain + taps * wetGain
+    void process(float* left, float* right, int numSamples, float dryGain, float wetGain)
+    {
+        const int activeLanes = numVoices * 2;
+        const float fb = feedback * feedbackNorm;
+        const float wet = wetGain * wetNorm;
+        float* lineL = lines[0].data();
+        float* lineR = lines[1].data();
+
+        alignas(32) std::array<float, NUM_LANES> tap{};
+
+        for (int start = 0; start < numSamples; start += CONTROL_INTERVAL)
+        {
+            const int n = std::min(CONTROL_INTERVAL, numSamples - start);
+            updateTargets(activeLanes, n);
+
+            for (int i = start; i < start + n; ++i)
+            {
+                // Fractional reads, linear interpolation (modulation hides the HF loss)
+                for (int lane = 0; lane < activeLanes; ++lane)
+                {
+                    const size_t idx = static_cast<size_t>(lane);
+                    const float d = delay[idx];
+                    const int whole = static_cast<int>(d);
+                    const float frac = d - static_cast<float>(whole);
+                    const float* line = (lane & 1) ? lineR : lineL;
+                    const float a = line[(writePos - whole) & mask];
+                    const float b = line[(writePos - whole - 1) & mask];
+                    tap[idx] = a + (b - a) * frac;
+                    delay[idx] += step[idx];
+                }
+
+                float sumL = 0.0f, sumR = 0.0f;
+                for (int lane = 0; lane < activeLanes; lane += 2)
+                {
+                    sumL += tap[static_cast<size_t>(lane)];
+                    sumR += tap[static_cast<size_t>(lane + 1)];
+                }
+
+                const float inL = left[i];
+                const float inR = right[i];
+                lineL[writePos] = inL + sumL * fb;
+                lineR[writePos] = inR + sumR * fb;
+                writePos = (writePos + 1) & mask;
+
+                left[i]  = inL * dryGain + sumL * wet;
+                right[i] = inR * dryGain + sumR * wet;
+            }
+        }
+    }
+
+private:
+    // Advance the LFO by one control step and set per-lane ramps to its new value
+    void updateTargets(int activeLanes, int n)
+    {
+        phase += phaseIncrement * static_cast<float>(n);
+        phase -= std::floor(phase);
+
+        const auto& table = LFOTable::sine();
+        const float voiceSpacing = 1.0f / static_cast<float>(numVoices);
+        const float inv = 1.0f / static_cast<float>(n);
+
+        for (int lane = 0; lane < activeLanes; ++lane)
+        {
+            const size_t idx = static_cast<size_t>(lane);
+            float p = phase + static_cast<float>(lane >> 1) * voiceSpacing + ((lane & 1) ? stereoPhase : 0.0f);
+            p -= std::floor(p);
+
+            const float target = centreSamples + depthSamples * table.lookup(p);
+            step[idx] = (target - delay[idx]) * inv;
+        }
+    }
+
+    void updateRange()
+    {
+        const float msToSamples = static_cast<float>(sampleRate * 0.001);
+        centreSamples = juce::jlimit(1.0f, std::max(1.0f, maxDelaySamples - 1.0f), centreMs * msToSamples);
+
+        // Keep the full swing inside [1, maxDelaySamples]
+        const float headroom = std::min(centreSamples - 1.0f, maxDelaySamples - centreSamples);
+        depthSamples = juce::jlimit(0.0f, std::max(0.0f, headroom), depthMs * msToSamples);
+    }
+
+    void updateRate()
+    {
+        phaseIncrement = static_cast<float>(rateHz / sampleRate);
+    }
+
+    double sampleRate = 44100.0;
+
+    std::array<std::vector<float>, 2> lines;
+    int mask = 0;
+    int writePos = 0;
+    float maxDelaySamples = 0.0f;
+
+    alignas(32) std::array<float, NUM_LANES> delay{};
+    alignas(32) std::array<float, NUM_LANES> step{};
+
+    float phase = 0.0f;
+    float phaseIncrement = 0.0f;
+
+    float centreMs = 7.0f;
+    float depthMs = 2.0f;
+    float rateHz = 1.0f;
+    float centreSamples = 1.0f;
+    float depthSamples = 0.0f;
+    float feedback = 0.0f;
+    float stereoPhase = 0.25f;
+
+    int numVoices = 1;
+    float wetNorm = 1.0f;
+    float feedbackNorm = 1.0f;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
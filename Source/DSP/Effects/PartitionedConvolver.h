@@ -0,0 +1,607 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Stereo non-uniform partitioned convolution
+ *
+ * The impulse response is split into three segments:
+ * - IR[0, 64)            direct-form FIR on the audio thread (zero latency)
+ * - IR[64, 1024)         64-sample FFT partitions on the audio thread
+ * - IR[1024, end)        512-sample FFT partitions on a high-priority worker
+ *
+ * Each FFT segment's inherent one-block latency is hidden by its offset in
+ * the IR. When a 512-sample input block completes, the audio thread
+ * transforms it into the tail's delay line and posts the multiply-accumulate
+ * as a job, due one block later. The audio thread never waits for the
+ * worker: a job that isn't done by its deadline is computed inline (the
+ * worker's copy, if it has started, is abandoned), so output is always
+ * complete and deterministic. Two job slots alternate, so a late job never
+ * holds up the next one.
+ *
+ * Kernels (IR spectra plus their convolution state) are built off the audio
+ * thread and swapped in lock-free at the next tail boundary.
+ */
+class PartitionedConvolver
+{
+public:
+    static constexpr int HEAD_BLOCK = 64;
+    static constexpr int TAIL_BLOCK = 512;
+    static constexpr int TAIL_START = 2 * TAIL_BLOCK;
+    static constexpr int NUM_CHANNELS = 2;
+
+    /**
+     * Uniformly partitioned overlap-save convolution of one IR section
+     * Spectra are stored split (re/im) so the complex multiply-accumulate vectorises.
+     */
+    class Segment
+    {
+    public:
+        /**
+         * spareSlots extra delay-line entries let a block be pushed while a
+         * convolution of an earlier block may still be reading the line.
+         */
+        void init(const float* ir, int irLength, int offset, int maxLength, int newBlockSize, juce::dsp::FFT& fft,
+                  int spareSlots = 0)
+        {
+            blockSize = newBlockSize;
+            numBins = blockSize + 1;
+
+            const int available = juce::jmax(0, juce::jmin(irLength, offset + maxLength) - offset);
+            numParts = (available + blockSize - 1) / blockSize;
+            numSlots = numParts > 0 ? numParts + spareSlots : 0;
+
+            const size_t spectrumSize = static_cast<size_t>(numParts * numBins);
+            const size_t fdlSize = static_cast<size_t>(numSlots * numBins);
+            filterRe.assign(spectrumSize, 0.0f);
+            filterIm.assign(spectrumSize, 0.0f);
+            fdlRe.assign(fdlSize, 0.0f);
+            fdlIm.assign(fdlSize, 0.0f);
+            accRe.assign(static_cast<size_t>(numBins), 0.0f);
+            accIm.assign(static_cast<size_t>(numBins), 0.0f);
+            inputTime.assign(static_cast<size_t>(2 * blockSize), 0.0f);
+            fftBuffer.assign(static_cast<size_t>(4 * blockSize), 0.0f);
+            fdlIndex = 0;
+
+            for (int p = 0; p < numParts; ++p)
+            {
+                std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+                const int start = offset + p * blockSize;
+                const int count = juce::jmin(blockSize, offset + available - start);
+                std::copy(ir + start, ir + start + count, fftBuffer.begin());
+
+                fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+                deinterleave(fftBuffer.data(), filterRe.data() + p * numBins, filterIm.data() + p * numBins);
+            }
+        }
+
+        bool isEmpty() const { return numParts == 0; }
+
+        void reset()
+        {
+            std::fill(fdlRe.begin(), fdlRe.end(), 0.0f);
+            std::fill(fdlIm.begin(), fdlIm.end(), 0.0f);
+            std::fill(inputTime.begin(), inputTime.end(), 0.0f);
+            fdlIndex = 0;
+        }
+
+        // Consume blockSize new input samples, write blockSize output samples
+        void process(const float* input, float* output, juce::dsp::FFT& fft)
+        {
+            if (numParts == 0)
+            {
+                std::fill(output, output + blockSize, 0.0f);
+                return;
+            }
+
+            const int newest = pushInput(input, fft);
+            convolve(newest, output, fft, accRe.data(), accIm.data(), fftBuffer.data());
+        }
+
+        // Slide the overlap-save window and transform it into the FDL; returns the slot it went to
+        int pushInput(const float* input, juce::dsp::FFT& fft)
+        {
+            std::copy(inputTime.begin() + blockSize, inputTime.end(), inputTime.begin());
+            std::copy(input, input + blockSize, inputTime.begin() + blockSize);
+
+            std::copy(inputTime.begin(), inputTime.end(), fftBuffer.begin());
+            std::fill(fftBuffer.begin() + 2 * blockSize, fftBuffer.end(), 0.0f);
+            fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+            deinterleave(fftBuffer.data(), fdlRe.data() + fdlIndex * numBins, fdlIm.data() + fdlIndex * numBins);
+
+            const int slot = fdlIndex;
+            fdlIndex = (fdlIndex + 1 == numSlots) ? 0 : fdlIndex + 1;
+            return slot;
+        }
+
+        /**
+         * Multiply-accumulate every partition against the FDL, newest block in
+         * `newestSlot`, and write blockSize output samples. Only reads the
+         * segment, so any thread can run it with its own scratch (numBins
+         * floats each for re/im, 4 * blockSize for the FFT). Returns false,
+         * output unwritten, if `abandon` is raised before it finishes.
+         */
+        bool convolve(int newestSlot, float* output, juce::dsp::FFT& fft,
+                      float* scratchRe, float* scratchIm, float* scratchFFT,
+                      const std::atomic<bool>* abandon = nullptr) const
+        {
+            std::fill(scratchRe, scratchRe + numBins, 0.0f);
+            std::fill(scratchIm, scratchIm + numBins, 0.0f);
+
+            int slot = newestSlot;
+            for (int p = 0; p < numParts; ++p)
+            {
+                if (abandon != nullptr && abandon->load(std::memory_order_relaxed))
+                    return false;
+
+                const float* hr = filterRe.data() + p * numBins;
+                const float* hi = filterIm.data() + p * numBins;
+                const float* xr = fdlRe.data() + slot * numBins;
+                const float* xi = fdlIm.data() + slot * numBins;
+
+                for (int k = 0; k < numBins; ++k)
+                {
+                    scratchRe[k] += hr[k] * xr[k] - hi[k] * xi[k];
+                    scratchIm[k] += hr[k] * xi[k] + hi[k] * xr[k];
+                }
+
+                slot = (slot == 0) ? numSlots - 1 : slot - 1;
+            }
+
+            // Back to time domain; the last half is the valid (non-aliased) output
+            for (int k = 0; k < numBins; ++k)
+            {
+                scratchFFT[2 * k] = scratchRe[k];
+                scratchFFT[2 * k + 1] = scratchIm[k];
+            }
+            std::fill(scratchFFT + 2 * numBins, scratchFFT + 4 * blockSize, 0.0f);
+            fft.performRealOnlyInverseTransform(scratchFFT);
+            std::copy(scratchFFT + blockSize, scratchFFT + 2 * blockSize, output);
+            return true;
+        }
+
+    private:
+        void deinterleave(const float* interleaved, float* re, float* im) const
+        {
+            for (int k = 0; k < numBins; ++k)
+            {
+                re[k] = interleaved[2 * k];
+                im[k] = interleaved[2 * k + 1];
+            }
+        }
+
+        int blockSize = 0;
+        int numBins = 0;
+        int numParts = 0;
+        int numSlots = 0;
+        int fdlIndex = 0;
+
+        std::vector<float> filterRe, filterIm;
+        std::vector<float> fdlRe, fdlIm;
+        std::vector<float> accRe, accIm;
+        std::vector<float> inputTime;
+        std::vector<float> fftBuffer;
+    };
+
+    /** An IR prepared for convolution, plus all the state that depends on it */
+    struct Kernel
+    {
+        struct Channel
+        {
+            alignas(16) std::array<float, HEAD_BLOCK> firTaps{};           // Reversed: oldest-to-newest
+            alignas(16) std::array<float, 2 * HEAD_BLOCK> firHistory{};    // Mirrored for contiguous reads
+            Segment head;
+            Segment tail;
+        };
+
+        std::array<Channel, NUM_CHANNELS> channels;
+        int length = 0;
+
+        void reset()
+        {
+            for (auto& ch : channels)
+            {
+                ch.firHistory.fill(0.0f);
+                ch.head.reset();
+                ch.tail.reset();
+            }
+        }
+    };
+
+    PartitionedConvolver()
+        : headFFT(juce::roundToInt(std::log2(2 * HEAD_BLOCK))),
+          audioTailFFT(juce::roundToInt(std::log2(2 * TAIL_BLOCK))),
+          worker(*this)
+    {
+    }
+
+    ~PartitionedConvolver()
+    {
+        worker.stopThread(2000);
+        delete current;
+        delete pending.exchange(nullptr);
+        collectGarbage();
+    }
+
+    void prepare()
+    {
+        resetStreams();
+        if (!worker.isThreadRunning())
+            worker.startThread(juce::Thread::Priority::high);
+    }
+
+    // Build a kernel from an IR already at the processing sample rate (never on the audio thread).
+    // A mono IR is used for both channels.
+    static std::unique_ptr<Kernel> createKernel(const juce::AudioBuffer<float>& ir)
+    {
+        auto kernel = std::make_unique<Kernel>();
+        kernel->length = ir.getNumSamples();
+
+        juce::dsp::FFT headFft(juce::roundToInt(std::log2(2 * HEAD_BLOCK)));
+        juce::dsp::FFT tailFft(juce::roundToInt(std::log2(2 * TAIL_BLOCK)));
+
+        for (int c = 0; c < NUM_CHANNELS; ++c)
+        {
+            const float* data = ir.getReadPointer(juce::jmin(c, ir.getNumChannels() - 1));
+            const int length = ir.getNumSamples();
+            auto& ch = kernel->channels[static_cast<size_t>(c)];
+
+            for (int i = 0; i < HEAD_BLOCK; ++i)
+                ch.firTaps[static_cast<size_t>(i)] = (HEAD_BLOCK - 1 - i < length) ? data[HEAD_BLOCK - 1 - i] : 0.0f;
+
+            ch.head.init(data, length, HEAD_BLOCK, TAIL_START - HEAD_BLOCK, HEAD_BLOCK, headFft);
+            ch.tail.init(data, length, TAIL_START, length, TAIL_BLOCK, tailFft, TAIL_SPARE_SLOTS);
+        }
+
+        return kernel;
+    }
+
+    // Hand a kernel to the audio thread; it is swapped in at the next tail boundary
+    void submitKernel(std::unique_ptr<Kernel> kernel)
+    {
+        delete pending.exchange(kernel.release(), std::memory_order_acq_rel);
+        collectGarbage();
+    }
+
+    // Free kernels the audio thread has swapped out (call from any non-audio thread)
+    void collectGarbage()
+    {
+        delete retired.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    bool hasKernel() const { return current != nullptr || pending.load(std::memory_order_acquire) != nullptr; }
+
+    // IR length plus the tail segment's pipeline delay (audio thread only)
+    int getTailLengthSamples() const { return current != nullptr ? current->length + 2 * TAIL_BLOCK : 0; }
+
+    // Clear all convolution history (not on the audio thread while processing)
+    void reset()
+    {
+        for (auto& job : jobs)
+        {
+            job.abandoned.store(true, std::memory_order_relaxed);
+
+            // Take the job back with a CAS so the worker can't claim it in between;
+            // a running job is left to finish and store JobDone before it's reclaimed.
+            int state = job.state.load(std::memory_order_acquire);
+            while (state == JobRunning
+                   || !job.state.compare_exchange_weak(state, JobIdle, std::memory_order_acq_rel))
+            {
+                if (state == JobRunning)
+                {
+                    std::this_thread::yield();
+                    state = job.state.load(std::memory_order_acquire);
+                }
+            }
+        }
+
+        resetStreams();
+        if (current != nullptr)
+            current->reset();
+    }
+
+    // In-place stereo processing: left/right become dry * (1 - mix) + wet * mix
+    void process(float* left, float* right, int numSamples, float mix)
+    {
+        if (current == nullptr)
+        {
+            // Nothing loaded yet: pick up a pending kernel as soon as one exists
+            installPendingKernel();
+            if (current == nullptr)
+            {
+                juce::FloatVectorOperations::multiply(left, 1.0f - mix, numSamples);
+                if (right != left)
+                    juce::FloatVectorOperations::multiply(right, 1.0f - mix, numSamples);
+                return;
+            }
+        }
+
+        const float dryGain = 1.0f - mix;
+        std::array<float*, NUM_CHANNELS> io { left, right };
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const int tailPos = tailFill + headPos;
+
+            for (int c = 0; c < NUM_CHANNELS; ++c)
+            {
+                const size_t cs = static_cast<size_t>(c);
+                auto& ch = current->channels[cs];
+                const float x = io[cs][n];
+
+                // Zero-latency head: direct FIR over a mirrored history window
+                ch.firHistory[static_cast<size_t>(firPos)] = x;
+                ch.firHistory[static_cast<size_t>(firPos + HEAD_BLOCK)] = x;
+                const float* window = ch.firHistory.data() + firPos + 1;
+
+                float wet = 0.0f;
+                for (int i = 0; i < HEAD_BLOCK; ++i)
+                    wet += ch.firTaps[static_cast<size_t>(i)] * window[i];
+
+                wet += headOutput[cs][static_cast<size_t>(headPos)] + tailOutput[cs][static_cast<size_t>(tailPos)];
+                headInput[cs][static_cast<size_t>(headPos)] = x;
+
+                io[cs][n] = x * dryGain + wet * mix;
+            }
+
+            firPos = (firPos + 1 == HEAD_BLOCK) ? 0 : firPos + 1;
+
+            if (++headPos == HEAD_BLOCK)
+            {
+                headPos = 0;
+                for (int c = 0; c < NUM_CHANNELS; ++c)
+                {
+                    const size_t cs = static_cast<size_t>(c);
+                    current->channels[cs].head.process(headInput[cs].data(), headOutput[cs].data(), headFFT);
+                    std::copy(headInput[cs].begin(), headInput[cs].end(), tailInput[cs].begin() + tailFill);
+                }
+
+                tailFill += HEAD_BLOCK;
+                if (tailFill == TAIL_BLOCK)
+                {
+                    tailFill = 0;
+                    tailBoundary();
+                }
+            }
+        }
+    }
+
+    // Tail jobs the worker didn't finish in time, computed by the audio thread instead
+    uint32_t getMissedDeadlineCount() const { return missedDeadlines.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int NUM_JOB_SLOTS = 2;
+
+    // The worker may still read an abandoned job's delay line for two more blocks
+    static constexpr int TAIL_SPARE_SLOTS = 2;
+
+    enum JobState : int { JobIdle, JobQueued, JobRunning, JobDone };
+
+    // Per-thread buffers for Segment::convolve() on the tail
+    struct Scratch
+    {
+        std::array<float, TAIL_BLOCK + 1> re{}, im{};
+        std::array<float, 4 * TAIL_BLOCK> fft{};
+    };
+
+    /** One posted tail block: which delay-line slots to convolve and where the result goes */
+    struct TailJob
+    {
+        std::atomic<int> state { JobIdle };
+        std::atomic<bool> abandoned { false };     // Set by the audio thread once it has computed the job itself
+        Kernel* kernel = nullptr;
+        std::array<int, NUM_CHANNELS> newestSlot{};
+        std::array<std::array<float, TAIL_BLOCK>, NUM_CHANNELS> output{};
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(PartitionedConvolver& o)
+            : juce::Thread("Convolution tail"), owner(o),
+              fft(juce::roundToInt(std::log2(2 * TAIL_BLOCK)))
+        {
+        }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                wakeUp.wait(20);
+                for (auto& job : owner.jobs)
+                {
+                    int expected = JobQueued;
+                    if (job.state.compare_exchange_strong(expected, JobRunning, std::memory_order_acq_rel))
+                    {
+                        runJob(job);
+                        job.state.store(JobDone, std::memory_order_release);
+                    }
+                }
+            }
+        }
+
+        juce::WaitableEvent wakeUp;
+
+    private:
+        void runJob(TailJob& job)
+        {
+            for (int c = 0; c < NUM_CHANNELS; ++c)
+            {
+                const size_t cs = static_cast<size_t>(c);
+                if (!job.kernel->channels[cs].tail.convolve(job.newestSlot[cs], job.output[cs].data(), fft,
+                                                            scratch.re.data(), scratch.im.data(), scratch.fft.data(),
+                                                            &job.abandoned))
+                    return;
+            }
+        }
+
+        PartitionedConvolver& owner;
+        juce::dsp::FFT fft;
+        Scratch scratch;
+    };
+
+    // Audio thread: the tail block for delay-line slots `newestSlot`, straight into tailOutput
+    void computeTailInline(const std::array<int, NUM_CHANNELS>& newestSlot)
+    {
+        missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+        for (int c = 0; c < NUM_CHANNELS; ++c)
+        {
+            const size_t cs = static_cast<size_t>(c);
+            current->channels[cs].tail.convolve(newestSlot[cs], tailOutput[cs].data(), audioTailFFT,
+                                                audioScratch.re.data(), audioScratch.im.data(), audioScratch.fft.data());
+        }
+    }
+
+    // Audio thread: fill tailOutput with the block posted one boundary ago, never waiting for the worker
+    void collectDueJob()
+    {
+        if (dueJob < 0)
+        {
+            if (dueInline)
+                computeTailInline(dueInlineSlots);
+            else
+                for (auto& out : tailOutput)
+                    out.fill(0.0f);
+            dueInline = false;
+            return;
+        }
+
+        auto& job = jobs[static_cast<size_t>(dueJob)];
+        dueJob = -1;
+
+        // Not started: take it back. Started: leave the worker to notice it was abandoned.
+        int expected = JobQueued;
+        if (job.state.compare_exchange_strong(expected, JobIdle, std::memory_order_acq_rel)
+            || expected == JobRunning)
+        {
+            job.abandoned.store(true, std::memory_order_relaxed);
+            computeTailInline(job.newestSlot);
+            return;
+        }
+
+        for (int c = 0; c < NUM_CHANNELS; ++c)
+        {
+            const size_t cs = static_cast<size_t>(c);
+            if (job.kernel == current)
+                tailOutput[cs] = job.output[cs];
+            else
+                tailOutput[cs].fill(0.0f);
+        }
+        job.state.store(JobIdle, std::memory_order_release);
+    }
+
+    bool isWorkerRunningJob() const
+    {
+        for (const auto& job : jobs)
+            if (job.state.load(std::memory_order_acquire) == JobRunning)
+                return true;
+        return false;
+    }
+
+    void tailBoundary()
+    {
+        // The job posted one tail block ago is due now
+        collectDueJob();
+
+        // A kernel can only change hands while the worker isn't reading one
+        if (!isWorkerRunningJob())
+            installPendingKernel();
+
+        if (current->channels[0].tail.isEmpty())
+            return;
+
+        std::array<int, NUM_CHANNELS> newestSlot{};
+        for (int c = 0; c < NUM_CHANNELS; ++c)
+        {
+            const size_t cs = static_cast<size_t>(c);
+            newestSlot[cs] = current->channels[cs].tail.pushInput(tailInput[cs].data(), audioTailFFT);
+        }
+
+        // Post to whichever slot the worker has let go of; if it is still stuck
+        // in both, the audio thread computes this block at the next boundary
+        for (int j = 0; j < NUM_JOB_SLOTS; ++j)
+        {
+            auto& job = jobs[static_cast<size_t>(j)];
+            const int state = job.state.load(std::memory_order_acquire);
+            if (state != JobIdle && state != JobDone)
+                continue;
+
+            job.kernel = current;
+            job.newestSlot = newestSlot;
+            job.abandoned.store(false, std::memory_order_relaxed);
+            job.state.store(JobQueued, std::memory_order_release);
+            dueJob = j;
+            worker.wakeUp.signal();
+            return;
+        }
+
+        dueInline = true;
+        dueInlineSlots = newestSlot;
+    }
+
+    void installPendingKernel()
+    {
+        // Only swap once the previous retiree has been collected
+        if (retired.load(std::memory_order_acquire) != nullptr)
+            return;
+
+        if (auto* next = pending.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            retired.store(current, std::memory_order_release);
+            current = next;
+            resetStreams();
+        }
+    }
+
+    void resetStreams()
+    {
+        for (int c = 0; c < NUM_CHANNELS; ++c)
+        {
+            const size_t cs = static_cast<size_t>(c);
+            headInput[cs].fill(0.0f);
+            headOutput[cs].fill(0.0f);
+            tailInput[cs].fill(0.0f);
+            tailOutput[cs].fill(0.0f);
+        }
+        headPos = 0;
+        tailFill = 0;
+        firPos = 0;
+        dueJob = -1;
+        dueInline = false;
+    }
+
+    juce::dsp::FFT headFFT;
+    juce::dsp::FFT audioTailFFT;
+
+    Kernel* current = nullptr;              // Audio thread only
+    std::atomic<Kernel*> pending { nullptr };
+    std::atomic<Kernel*> retired { nullptr };
+
+    // Audio-thread streaming state
+    std::array<std::array<float, HEAD_BLOCK>, NUM_CHANNELS> headInput{}, headOutput{};
+    std::array<std::array<float, TAIL_BLOCK>, NUM_CHANNELS> tailInput{}, tailOutput{};
+    int headPos = 0;
+    int tailFill = 0;
+    int firPos = 0;
+
+    // Tail jobs shared with the worker; the rest is audio thread only
+    std::array<TailJob, NUM_JOB_SLOTS> jobs;
+    int dueJob = -1;                                    // Slot posted at the last boundary
+    bool dueInline = false;                             // No slot was free: compute it here
+    std::array<int, NUM_CHANNELS> dueInlineSlots{};
+    Scratch audioScratch;
+    std::atomic<uint32_t> missedDeadlines { 0 };
+
+    Worker worker;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
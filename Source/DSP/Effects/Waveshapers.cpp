@@ -0,0 +1 @@
+// Stub - implementation in header
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Waveshapers with closed-form antiderivatives for ADAA
+ * Each shaper provides f (the curve), F1 = integral of f and F2 = integral
+ * of F1. Everything is in double: ADAA divides differences of nearby
+ * antiderivative values, which float cannot resolve.
+ */
+namespace Waveshapers {
+
+struct SoftClip
+{
+    double f(double x) const { return std::tanh(x); }
+
+    // log(cosh(x)), written to avoid overflow for large |x|
+    double F1(double x) const
+    {
+        const double a = std::abs(x);
+        return a + std::log1p(std::exp(-2.0 * a)) - LN2;
+    }
+
+    // Integral of log(cosh): x^2/2 - x ln2 + (Li2(-e^-2x) + pi^2/12) / 2, odd-symmetric
+    double F2(double x) const
+    {
+        const double a = std::abs(x);
+        const double r = 0.5 * a * a - a * LN2 + 0.5 * (dilogNegative(std::exp(-2.0 * a)) + PI_SQ_OVER_12);
+        return x < 0.0 ? -r : r;
+    }
+
+private:
+    static constexpr double LN2 = 0.69314718055994530942;
+    static constexpr double PI_SQ_OVER_12 = 0.82246703342411321824;
+
+    // Li2(-u) for u in [0, 1]. Landen's identity maps the argument to
+    // w = u / (1 + u) <= 0.5, where the power series converges quickly.
+    static double dilogNegative(double u)
+    {
+        if (u < 1.0e-9)
+            return -u;
+
+        const double w = u / (1.0 + u);
+        double term = w;
+        double sum = 0.0;
+        for (int k = 1; k <= 40 && term > 1.0e-17; ++k)
+        {
+            sum += term / (static_cast<double>(k) * k);
+            term *= w;
+        }
+
+        const double l = std::log1p(u);
+        return -sum - 0.5 * l * l;
+    }
+};
+
+struct HardClip
+{
+    double f(double x) const { return juce::jlimit(-1.0, 1.0, x); }
+
+    double F1(double x) const
+    {
+        const double a = std::abs(x);
+        return a <= 1.0 ? 0.5 * x * x : a - 0.5;
+    }
+
+    double F2(double x) const
+    {
+        const double a = std::abs(x);
+        const double r = a <= 1.0 ? a * a * a / 6.0 : 0.5 * a * a - 0.5 * a + 1.0 / 6.0;
+        return x < 0.0 ? -r : r;
+    }
+};
+
+// Exponential "tube" saturation: sign(x) * (1 - e^-|x|)
+struct Tube
+{
+    double f(double x) const
+    {
+        const double r = 1.0 - std::exp(-std::abs(x));
+        return x < 0.0 ? -r : r;
+    }
+
+    double F1(double x) const
+    {
+        const double a = std::abs(x);
+        return a + std::exp(-a) - 1.0;
+    }
+
+    double F2(double x) const
+    {
+        const double a = std::abs(x);
+        const double r = 0.5 * a * a - a + 1.0 - std::exp(-a);
+        return x < 0.0 ? -r : r;
+    }
+};
+
+// Triangle-wave wavefolder in closed form (period 4, unity slope through 0)
+struct Foldback
+{
+    double f(double x) const
+    {
+        return 1.0 - std::abs(wrap(x) - 2.0);
+    }
+
+    double F1(double x) const
+    {
+        const double m = wrap(x);
+        return m <= 2.0 ? 0.5 * m * m - m
+                        : -0.5 * m * m + 3.0 * m - 4.0;
+    }
+
+    double F2(double x) const
+    {
+        const double m = wrap(x);
+        if (m <= 2.0)
+            return m * m * m / 6.0 - 0.5 * m * m;
+
+        return -2.0 / 3.0 - (m * m * m - 8.0) / 6.0 + 1.5 * (m * m - 4.0) - 4.0 * (m - 2.0);
+    }
+
+private:
+    // (x + 1) mod 4, in [0, 4)
+    static double wrap(double x)
+    {
+        const double t = x + 1.0;
+        return t - 4.0 * std::floor(t * 0.25);
+    }
+};
+
+// Mid-tread quantiser with a precomputed step
+struct Bitcrush
+{
+    double step = 1.0 / 256.0;
+    double invStep = 256.0;
+
+    void setBitDepth(int bits)
+    {
+        invStep = std::exp2(static_cast<double>(bits));
+        step = 1.0 / invStep;
+    }
+
+    double f(double x) const { return step * std::round(x * invStep); }
+
+    // Written as x^2/2 minus a periodic correction, so no loop over steps
+    double F1(double x) const
+    {
+        const double r = residual(x);
+        return 0.5 * x * x - 0.5 * step * step * r * r;
+    }
+
+    double F2(double x) const
+    {
+        const double u = x * invStep;
+        const double r = u - std::round(u);
+        return x * x * x / 6.0 - step * step * step * (u / 24.0 + r * r * r / 6.0 - r / 24.0);
+    }
+
+private:
+    double residual(double x) const
+    {
+        const double u = x * invStep;
+        return u - std::round(u);
+    }
+};
+
+} // namespace Waveshapers
+} // namespace DSP
+} // namespace NulyBeats
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Normalised biquad coefficients (a0 == 1)
+ * RBJ cookbook designs computed in place - unlike juce::dsp::IIR::Coefficients
+ * these never touch the heap, so they are safe to recompute on the audio thread.
+ */
+struct BiquadCoefficients
+{
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+
+    void makeLowShelf(double sampleRate, float freq, float q, float gainFactor)
+    {
+        const double A = std::sqrt(static_cast<double>(juce::jmax(gainFactor, 1.0e-6f)));
+        const double aminus1 = A - 1.0;
+        const double aplus1 = A + 1.0;
+        const double omega = juce::MathConstants<double>::twoPi * clampFrequency(sampleRate, freq) / sampleRate;
+        const double coso = std::cos(omega);
+        const double beta = std::sin(omega) * std::sqrt(A) / q;
+        const double aminusTimesCos = aminus1 * coso;
+
+        set(A * (aplus1 - aminusTimesCos + beta),
+            A * 2.0 * (aminus1 - aplus1 * coso),
+            A * (aplus1 - aminusTimesCos - beta),
+            aplus1 + aminusTimesCos + beta,
+            -2.0 * (aminus1 + aplus1 * coso),
+            aplus1 + aminusTimesCos - beta);
+    }
+
+    void makeHighShelf(double sampleRate, float freq, float q, float gainFactor)
+    {
+        const double A = std::sqrt(static_cast<double>(juce::jmax(gainFactor, 1.0e-6f)));
+        const double aminus1 = A - 1.0;
+        const double aplus1 = A + 1.0;
+        const double omega = juce::MathConstants<double>::twoPi * clampFrequency(sampleRate, freq) / sampleRate;
+        const double coso = std::cos(omega);
+        const double beta = std::sin(omega) * std::sqrt(A) / q;
+        const double aminusTimesCos = aminus1 * coso;
+
+        set(A * (aplus1 + aminusTimesCos + beta),
+            A * -2.0 * (aminus1 + aplus1 * coso),
+            A * (aplus1 + aminusTimesCos - beta),
+            aplus1 - aminusTimesCos + beta,
+            2.0 * (aminus1 - aplus1 * coso),
+            aplus1 - aminusTimesCos - beta);
+    }
+
+    void makePeak(double sampleRate, float freq, float q, float gainFactor)
+    {
+        const double A = std::sqrt(static_cast<double>(juce::jmax(gainFactor, 1.0e-6f)));
+        const double omega = juce::MathConstants<double>::twoPi * clampFrequency(sampleRate, freq) / sampleRate;
+        const double alpha = std::sin(omega) / (2.0 * q);
+        const double c2 = -2.0 * std::cos(omega);
+
+        set(1.0 + alpha * A, c2, 1.0 - alpha * A,
+            1.0 + alpha / A, c2, 1.0 - alpha / A);
+    }
+
+private:
+    static double clampFrequency(double sampleRate, float freq)
+    {
+        return juce::jlimit(10.0, sampleRate * 0.49, static_cast<double>(freq));
+    }
+
+    void set(double nb0, double nb1, double nb2, double na0, double na1, double na2)
+    {
+        const double inv = 1.0 / na0;
+        b0 = static_cast<float>(nb0 * inv);
+        b1 = static_cast<float>(nb1 * inv);
+        b2 = static_cast<float>(nb2 * inv);
+        a1 = static_cast<float>(na1 * inv);
+        a2 = static_cast<float>(na2 * inv);
+    }
+};
+
+/**
+ * Stereo cascade of transposed direct form II biquads
+ * - Left/right run in lockstep as two lanes of one state array, so each
+ *   section update is a 2-wide vector operation
+ * - Coefficient changes are interpolated linearly across the next block
+ *   instead of stepping (no zipper noise on knob moves)
+ */
+template <int NumSections>
+class StereoBiquadCascade
+{
+public:
+    static constexpr int NUM_LANES = 2;
+
+    void reset()
+    {
+        for (auto& s : state)
+        {
+            s.s1.fill(0.0f);
+            s.s2.fill(0.0f);
+        }
+    }
+
+    // Jump straight to new coefficients (use when not running, e.g. in prepare)
+    void setCoefficients(int section, const BiquadCoefficients& c)
+    {
+        current[static_cast<size_t>(section)] = c;
+        target[static_cast<size_t>(section)] = c;
+    }
+
+    // Ramp to new coefficients over the next processed block
+    void setTargetCoefficients(int section, const BiquadCoefficients& c)
+    {
+        target[static_cast<size_t>(section)] = c;
+        ramping = true;
+    }
+
+    void process(float* left, float* right, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (ramping)
+        {
+            processRamped(left, right, numSamples);
+            current = target;
+            ramping = false;
+        }
+        else
+        {
+            processSteady(left, right, numSamples);
+        }
+    }
+
+private:
+    struct LaneState
+    {
+        alignas(8) std::array<float, NUM_LANES> s1{};
+        alignas(8) std::array<float, NUM_LANES> s2{};
+    };
+
+    static inline void tick(const BiquadCoefficients& c, LaneState& s, std::array<float, NUM_LANES>& x)
+    {
+        for (int lane = 0; lane < NUM_LANES; ++lane)
+        {
+            const float in = x[static_cast<size_t>(lane)];
+            const float out = c.b0 * in + s.s1[static_cast<size_t>(lane)];
+            s.s1[static_cast<size_t>(lane)] = c.b1 * in - c.a1 * out + s.s2[static_cast<size_t>(lane)];
+            s.s2[static_cast<size_t>(lane)] = c.b2 * in - c.a2 * out;
+            x[static_cast<size_t>(lane)] = out;
+        }
+    }
+
+    void processSteady(float* left, float* right, int numSamples)
+    {
+        // Local copies keep coefficients and state in registers
+        auto coeffs = current;
+        auto st = state;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            std::array<float, NUM_LANES> x { left[i], right[i] };
+
+            for (int k = 0; k < NumSections; ++k)
+                tick(coeffs[static_cast<size_t>(k)], st[static_cast<size_t>(k)], x);
+
+            left[i] = x[0];
+            right[i] = x[1];
+        }
+
+        state = st;
+        flushDenormals();
+    }
+
+    void processRamped(float* left, float* right, int numSamples)
+    {
+        auto coeffs = current;
+        std::array<BiquadCoefficients, NumSections> delta;
+        const float inv = 1.0f / static_cast<float>(numSamples);
+
+        for (size_t k = 0; k < static_cast<size_t>(NumSections); ++k)
+        {
+            delta[k].b0 = (target[k].b0 - coeffs[k].b0) * inv;
+            delta[k].b1 = (target[k].b1 - coeffs[k].b1) * inv;
+            delta[k].b2 = (target[k].b2 - coeffs[k].b2) * inv;
+            delta[k].a1 = (target[k].a1 - coeffs[k].a1) * inv;
+            delta[k].a2 = (target[k].a2 - coeffs[k].a2) * inv;
+        }
+
+        auto st = state;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            std::array<float, NUM_LANES> x { left[i], right[i] };
+
+            for (size_t k = 0; k < static_cast<size_t>(NumSections); ++k)
+            {
+                coeffs[k].b0 += delta[k].b0;
+                coeffs[k].b1 += delta[k].b1;
+                coeffs[k].b2 += delta[k].b2;
+                coeffs[k].a1 += delta[k].a1;
+                coeffs[k].a2 += delta[k].a2;
+                tick(coeffs[k], st[k], x);
+            }
+
+            left[i] = x[0];
+            right[i] = x[1];
+        }
+
+        state = st;
+        flushDenormals();
+    }
+
+    void flushDenormals()
+    {
+        for (auto& s : state)
+        {
+            for (int lane = 0; lane < NUM_LANES; ++lane)
+            {
+                if (std::abs(s.s1[static_cast<size_t>(lane)]) < 1.0e-15f) s.s1[static_cast<size_t>(lane)] = 0.0f;
+                if (std::abs(s.s2[static_cast<size_t>(lane)]) < 1.0e-15f) s.s2[static_cast<size_t>(lane)] = 0.0f;
+            }
+        }
+    }
+
+    std::array<BiquadCoefficients, NumSections> current{};
+    std::array<BiquadCoefficients, NumSections> target{};
+    std::array<LaneState, NumSections> state{};
+    bool ramping = false;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
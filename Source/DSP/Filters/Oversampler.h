@@ -0,0 +1,173 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Polyphase half-band FIR decimator (2:1)
+ *
+ * A half-band filter of length 4K-1 has every other tap equal to zero and
+ * a centre tap of 0.5. Split into polyphase branches:
+ * - Even-phase input runs through a 2K-tap symmetric FIR
+ * - Odd-phase input is only a K-sample delay (the centre tap)
+ *
+ * The even-phase history is mirrored into a double-length buffer so the
+ * 2K-tap dot product always reads one contiguous, aligned window, which
+ * the compiler vectorises.
+ */
+template <int K>
+class HalfBandDecimator
+{
+public:
+    static constexpr int NUM_TAPS = 2 * K;     // Non-zero even-phase taps
+    static constexpr int LATENCY = 2 * K - 1;  // Group delay in input samples
+
+    HalfBandDecimator() { reset(); }
+
+    void reset()
+    {
+        evenHistory.fill(0.0f);
+        oddDelay.fill(0.0f);
+        writeIndex = 0;
+        oddIndex = 0;
+    }
+
+    // Consume two input samples (even, odd) and produce one output sample
+    float process(float even, float odd)
+    {
+        evenHistory[static_cast<size_t>(writeIndex)] = even;
+        evenHistory[static_cast<size_t>(writeIndex + NUM_TAPS)] = even;
+
+        const float* window = evenHistory.data() + writeIndex + 1;
+        const auto& c = getCoefficients();
+
+        float acc = 0.0f;
+        for (int i = 0; i < NUM_TAPS; ++i)
+            acc += c[static_cast<size_t>(i)] * window[i];
+
+        float centre = oddDelay[static_cast<size_t>(oddIndex)];
+        oddDelay[static_cast<size_t>(oddIndex)] = odd;
+        oddIndex = (oddIndex + 1 == K) ? 0 : oddIndex + 1;
+
+        writeIndex = (writeIndex + 1 == NUM_TAPS) ? 0 : writeIndex + 1;
+
+        return acc + 0.5f * centre;
+    }
+
+    // Windowed-sinc design, laid out oldest-to-newest to match the history window
+    static const std::array<float, NUM_TAPS>& getCoefficients()
+    {
+        static const std::array<float, NUM_TAPS> coeffs = design();
+        return coeffs;
+    }
+
+private:
+    static std::array<float, NUM_TAPS> design()
+    {
+        constexpr int length = 4 * K - 1;
+        constexpr double centre = (length - 1) * 0.5;
+        const double pi = juce::MathConstants<double>::pi;
+
+        std::array<float, NUM_TAPS> c{};
+        double sum = 0.0;
+
+        for (int i = 0; i < NUM_TAPS; ++i)
+        {
+            // Tap i sits (2K - 1 - 2i) input samples before the centre
+            const double m = static_cast<double>(2 * K - 1 - 2 * i);
+            const double sinc = std::sin(pi * m * 0.5) / (pi * m);
+
+            // 4-term Blackman-Harris window
+            const double p = (centre - m + 1.0) / (length + 1);
+            const double w = 0.35875 - 0.48829 * std::cos(2.0 * pi * p)
+                           + 0.14128 * std::cos(4.0 * pi * p)
+                           - 0.01168 * std::cos(6.0 * pi * p);
+
+            c[static_cast<size_t>(i)] = static_cast<float>(sinc * w);
+            sum += sinc * w;
+        }
+
+        // Even-phase taps sum to 0.5 so DC gain is unity with the 0.5 centre tap
+        for (auto& v : c)
+            v = static_cast<float>(v * 0.5 / sum);
+
+        return c;
+    }
+
+    alignas(16) std::array<float, 2 * NUM_TAPS> evenHistory{};
+    std::array<float, K> oddDelay{};
+    int writeIndex = 0;
+    int oddIndex = 0;
+};
+
+/**
+ * Per-voice oversampler (1x / 2x / 4x)
+ * The voice renders `factor` samples per output sample and hands them here
+ * to be decimated back to the host rate through cascaded half-band stages.
+ */
+class Oversampler
+{
+public:
+    static constexpr int MAX_FACTOR = 4;
+
+    void setFactor(int newFactor)
+    {
+        factor = (newFactor >= 4) ? 4 : (newFactor >= 2 ? 2 : 1);
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+
+    void reset()
+    {
+        stage4to2.reset();
+        stage2to1.reset();
+    }
+
+    // Decimate `factor` consecutive oversampled values into one output sample
+    float process(const float* in)
+    {
+        switch (factor)
+        {
+            case 2:
+                return stage2to1.process(in[0], in[1]);
+
+            case 4:
+            {
+                float a = stage4to2.process(in[0], in[1]);
+                float b = stage4to2.process(in[2], in[3]);
+                return stage2to1.process(a, b);
+            }
+
+            default:
+                return in[0];
+        }
+    }
+
+    // Latency at the host rate, in samples
+    float getLatencyInSamples() const
+    {
+        switch (factor)
+        {
+            case 2:  return FinalStage::LATENCY / 2.0f;
+            case 4:  return FirstStage::LATENCY / 4.0f + FinalStage::LATENCY / 2.0f;
+            default: return 0.0f;
+        }
+    }
+
+private:
+    // The 4x->2x stage has a wide transition band, so it can be much shorter
+    using FirstStage = HalfBandDecimator<4>;
+    using FinalStage = HalfBandDecimator<12>;
+
+    FirstStage stage4to2;
+    FinalStage stage2to1;
+    int factor = 1;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
@@ -36,19 +36,31 @@ public:
 
     void setType(Type newType)
     {
+        if (newType == type)
+            return;
+
         type = newType;
+        updateOutputMix();
     }
 
     void setCutoff(float freq)
     {
-        cutoffFreq = juce::jlimit(20.0f, static_cast<float>(sampleRate * 0.49), freq);
+        float newCutoff = juce::jlimit(20.0f, static_cast<float>(sampleRate * 0.49), freq);
+        if (newCutoff == cutoffFreq)
+            return; // Skip the tan() when nothing moved
+
+        cutoffFreq = newCutoff;
         updateCoefficients();
     }
 
     void setResonance(float res)
     {
         // Resonance 0-1, where 1 = self-oscillation
-        resonance = juce::jlimit(0.0f, 1.0f, res);
+        float newResonance = juce::jlimit(0.0f, 1.0f, res);
+        if (newResonance == resonance)
+            return;
+
+        resonance = newResonance;
         updateCoefficients();
     }
 
@@ -68,26 +80,9 @@ public:
         ic1eq = 2.0f * v1 - ic1eq;
         ic2eq = 2.0f * v2 - ic2eq;
 
-        // Output mixing based on filter type
-        switch (type)
-        {
-            case Type::LowPass:
-                return v2;
-            case Type::HighPass:
-                return input - k * v1 - v2;
-            case Type::BandPass:
-                return v1;
-            case Type::Notch:
-                return input - k * v1;
-            case Type::Peak:
-                return input - k * v1 + v2 * (gain - 1.0f);
-            case Type::LowShelf:
-                return input + v2 * (gain - 1.0f);
-            case Type::HighShelf:
-                return input + (input - k * v1 - v2) * (gain - 1.0f);
-            default:
-                return v2;
-        }
+        // Every type is a weighted sum of input, band and low outputs;
+        // the weights are resolved when the type or coefficients change
+        return mixInput * input + mixBand * v1 + mixLow * v2;
     }
 
     void processBlock(float* samples, int numSamples)
@@ -141,6 +136,32 @@ private:
         a1 = 1.0f / (1.0f + g * (g + k));
         a2 = g * a1;
         a3 = g * a2;
+
+        updateOutputMix();
+    }
+
+    void updateOutputMix()
+    {
+        const float boost = gain - 1.0f;
+
+        switch (type)
+        {
+            case Type::LowPass:   setOutputMix(0.0f, 0.0f, 1.0f); break;
+            case Type::HighPass:  setOutputMix(1.0f, -k, -1.0f); break;
+            case Type::BandPass:  setOutputMix(0.0f, 1.0f, 0.0f); break;
+            case Type::Notch:     setOutputMix(1.0f, -k, 0.0f); break;
+            case Type::Peak:      setOutputMix(1.0f, -k, boost); break;
+            case Type::LowShelf:  setOutputMix(1.0f, 0.0f, boost); break;
+            case Type::HighShelf: setOutputMix(gain, -k * boost, -boost); break;     // input + highpass * boost
+            default:              setOutputMix(0.0f, 0.0f, 1.0f); break;
+        }
+    }
+
+    void setOutputMix(float input, float band, float low)
+    {
+        mixInput = input;
+        mixBand = band;
+        mixLow = low;
     }
 
     double sampleRate = 44100.0;
@@ -156,6 +177,11 @@ private:
     float a2 = 0.0f;
     float a3 = 0.0f;
 
+    // Output weights for the current type (LowPass by default)
+    float mixInput = 0.0f;
+    float mixBand = 0.0f;
+    float mixLow = 1.0f;
+
     // State
     float ic1eq = 0.0f;
     float ic2eq = 0.0f;
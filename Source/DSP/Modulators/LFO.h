@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../Oscillators/NoiseGenerator.h"
 #include <cmath>
 
 namespace NulyBeats {
@@ -39,9 +40,11 @@ public:
     void prepare(double sampleRate)
     {
         this->sampleRate = sampleRate;
-        random.setSeed(juce::Time::currentTimeMillis());
     }
 
+    // Seed for S&H / smooth random (deterministic per voice)
+    void setSeed(uint32_t seed) { noise.setSeed(seed); }
+
     void setRate(float rate)
     {
         if (syncMode == SyncMode::Free)
@@ -104,7 +107,7 @@ public:
             case Waveform::SampleAndHold:
                 // New random value at start of each cycle
                 if (effectivePhase < lastPhase)
-                    holdValue = random.nextFloat() * 2.0f - 1.0f;
+                    holdValue = noise.nextWhite();
                 output = holdValue;
                 break;
 
@@ -113,7 +116,7 @@ public:
                 if (effectivePhase < lastPhase)
                 {
                     prevRandomValue = nextRandomValue;
-                    nextRandomValue = random.nextFloat() * 2.0f - 1.0f;
+                    nextRandomValue = noise.nextWhite();
                 }
                 // Smooth interpolation
                 output = prevRandomValue + effectivePhase * (nextRandomValue - prevRandomValue);
@@ -141,13 +144,23 @@ public:
         return output;
     }
 
+    // Control-rate use: returns the value at the current phase, then advances
+    // the phase by numSamples
+    float advance(int numSamples)
+    {
+        const float output = process();
+        phase += static_cast<float>(phaseIncrement * (numSamples - 1));
+        phase -= std::floor(phase);
+        return output;
+    }
+
     void reset()
     {
         phase = 0.0f;
         fadeLevel = 0.0f;
         holdValue = 0.0f;
         prevRandomValue = 0.0f;
-        nextRandomValue = random.nextFloat() * 2.0f - 1.0f;
+        nextRandomValue = noise.nextWhite();
     }
 
     void retrigger()
@@ -177,7 +190,7 @@ private:
     float holdValue = 0.0f;
     float prevRandomValue = 0.0f;
     float nextRandomValue = 0.0f;
-    juce::Random random;
+    NoiseGenerator noise;
 };
 
 } // namespace DSP
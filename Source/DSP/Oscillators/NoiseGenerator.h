@@ -0,0 +1,172 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace NulyBeats {
+namespace DSP {
+
+/**
+ * Counter-based noise source (replaces juce::Random in the audio path)
+ * - Each output is a hash of (seed, counter), so there is no loop-carried
+ *   state and block fills vectorise cleanly
+ * - Seedable per voice for deterministic renders
+ * - White, pink (Paul Kellet economy filter) and brown (leaky integrator)
+ *
+ * Integer -> float conversion uses the mantissa bit trick instead of a divide.
+ */
+class NoiseGenerator
+{
+public:
+    enum class Colour
+    {
+        White,
+        Pink,
+        Brown
+    };
+
+    NoiseGenerator() = default;
+    explicit NoiseGenerator(uint32_t initialSeed) { setSeed(initialSeed); }
+
+    void setSeed(uint32_t newSeed)
+    {
+        seed = hash(newSeed ^ 0x9e3779b9u);
+        reset();
+    }
+
+    uint32_t getSeed() const { return seed; }
+
+    void setColour(Colour c) { colour = c; }
+    Colour getColour() const { return colour; }
+
+    /**
+     * Gain that restores the level of noise generated at `factor` times the
+     * host rate (1, 2 or 4) once it is decimated back down. The decimator
+     * keeps only the band below the host Nyquist, and how much power lies
+     * there depends on the colour: 1/factor for white, nearly all of it for
+     * brown. Values are from each colour's filter response.
+     */
+    static float getDecimationGain(Colour c, int factor)
+    {
+        const int index = factor >= 4 ? 2 : (factor >= 2 ? 1 : 0);
+        switch (c)
+        {
+            case Colour::White: return std::array<float, 3> { 1.0f, 1.4142136f, 2.0f }[static_cast<size_t>(index)];
+            case Colour::Pink:  return std::array<float, 3> { 1.0f, 1.0392095f, 1.0853147f }[static_cast<size_t>(index)];
+            case Colour::Brown: return std::array<float, 3> { 1.0f, 1.0003188f, 1.0007701f }[static_cast<size_t>(index)];
+        }
+        return 1.0f;
+    }
+
+    void reset()
+    {
+        counter = 0;
+        pinkB0 = pinkB1 = pinkB2 = 0.0f;
+        brownState = 0.0f;
+    }
+
+    // Single bipolar white sample in [-1, 1)
+    float nextWhite()
+    {
+        return toBipolarFloat(hash(seed + (counter++) * 0x9e3779b9u));
+    }
+
+    // Single sample of the current colour
+    float next()
+    {
+        float w = nextWhite();
+        switch (colour)
+        {
+            case Colour::White: return w;
+            case Colour::Pink:  return pinkSample(w);
+            case Colour::Brown: return brownSample(w);
+        }
+        return w;
+    }
+
+    // Fill a block with bipolar white noise
+    void fillWhite(float* dest, int numSamples)
+    {
+        const uint32_t base = counter;
+        const uint32_t s = seed;
+
+        // Independent iterations: the compiler emits SIMD for this loop
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = toBipolarFloat(hash(s + (base + static_cast<uint32_t>(i)) * 0x9e3779b9u));
+
+        counter = base + static_cast<uint32_t>(numSamples);
+    }
+
+    // Fill a block with noise of the current colour
+    void fillBlock(float* dest, int numSamples)
+    {
+        fillWhite(dest, numSamples);
+
+        if (colour == Colour::Pink)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = pinkSample(dest[i]);
+        }
+        else if (colour == Colour::Brown)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = brownSample(dest[i]);
+        }
+    }
+
+    // Fill a block and scale it in one pass (level applied after colouring)
+    void fillBlock(float* dest, int numSamples, float gain)
+    {
+        fillBlock(dest, numSamples);
+        juce::FloatVectorOperations::multiply(dest, gain, numSamples);
+    }
+
+private:
+    // 32-bit integer finaliser (lowbias32, C. Wellons)
+    static uint32_t hash(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    // Top 23 bits into the mantissa of [2, 4), then shift to [-1, 1)
+    static float toBipolarFloat(uint32_t x)
+    {
+        return std::bit_cast<float>((x >> 9) | 0x40000000u) - 3.0f;
+    }
+
+    float pinkSample(float white)
+    {
+        pinkB0 = 0.99765f * pinkB0 + white * 0.0990460f;
+        pinkB1 = 0.96300f * pinkB1 + white * 0.2965164f;
+        pinkB2 = 0.57000f * pinkB2 + white * 1.0526913f;
+        return (pinkB0 + pinkB1 + pinkB2 + white * 0.1848f) * 0.25f;
+    }
+
+    float brownSample(float white)
+    {
+        brownState = 0.998f * brownState + white * 0.0625f;
+        return brownState * 3.5f;
+    }
+
+    uint32_t seed = 0x6d2b79f5u;
+    uint32_t counter = 0;
+    Colour colour = Colour::White;
+
+    // Pink filter state
+    float pinkB0 = 0.0f;
+    float pinkB1 = 0.0f;
+    float pinkB2 = 0.0f;
+
+    // Brown integrator state
+    float brownState = 0.0f;
+};
+
+} // namespace DSP
+} // namespace NulyBeats
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "NoiseGenerator.h"
 #include <cmath>
 #include <array>
 
@@ -42,6 +43,10 @@ public:
     void setWaveform(Waveform wf) { waveform = wf; }
     void setPulseWidth(float pw) { pulseWidth = juce::jlimit(0.01f, 0.99f, pw); }
     void setDetune(float cents) { detuneRatio = std::pow(2.0f, cents / 1200.0f); }
+    void setNoiseSeed(uint32_t seed) { noise.setSeed(seed); }
+
+    // Level correction for the Noise waveform when running oversampled
+    void setNoiseGain(float gain) { noiseGain = gain; }
 
     float process()
     {
@@ -136,7 +141,7 @@ private:
 
     float processNoise() const
     {
-        return random.nextFloat() * 2.0f - 1.0f;
+        return noise.nextWhite() * noiseGain;
     }
 
     void advancePhase()
@@ -155,7 +160,8 @@ private:
     Waveform waveform = Waveform::Saw;
 
     mutable float triangleIntegrator = 0.0f;
-    mutable juce::Random random;
+    mutable NoiseGenerator noise;
+    float noiseGain = 1.0f;
 };
 
 } // namespace DSP
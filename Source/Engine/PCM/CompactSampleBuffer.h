@@ -0,0 +1,210 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace NulyBeats {
+namespace Engine {
+
+/**
+ * Sample audio stored at a chosen width
+ * - Float32: as decoded (also used as a view onto memory owned elsewhere)
+ * - Int16:   16-bit sources, losslessly; half the size of float
+ * - Int24:   24-bit sources, packed little-endian 3-byte words; 3/4 of float
+ *
+ * Voices convert on the fly: decode() turns a run of frames into float with
+ * branch-free loops the compiler vectorises, getSample() reads one frame.
+ * Memory is one contiguous block per channel, so a run stays cache-friendly.
+ */
+class CompactSampleBuffer
+{
+public:
+    enum class Encoding : uint8_t
+    {
+        Float32,
+        Int16,
+        Int24
+    };
+
+    // Narrowest encoding that holds the reader's data without loss
+    static Encoding nativeEncodingFor(const juce::AudioFormatReader& reader)
+    {
+        if (reader.usesFloatingPointData || reader.bitsPerSample > 24)
+            return Encoding::Float32;
+        return reader.bitsPerSample <= 16 ? Encoding::Int16 : Encoding::Int24;
+    }
+
+    static int bytesPerSample(Encoding e)
+    {
+        switch (e)
+        {
+            case Encoding::Int16: return 2;
+            case Encoding::Int24: return 3;
+            case Encoding::Float32: break;
+        }
+        return 4;
+    }
+
+    CompactSampleBuffer() = default;
+    CompactSampleBuffer(CompactSampleBuffer&&) = default;   // Heap blocks move, so channelData stays valid
+    CompactSampleBuffer& operator=(CompactSampleBuffer&&) = default;
+
+    // Frames [0, numFramesToRead) of `reader`, then zeros up to totalFrames
+    CompactSampleBuffer(juce::AudioFormatReader& reader, int channels, int numFramesToRead, int totalFrames, Encoding e)
+        : encoding(e),
+          numChannels(channels),
+          numFrames(totalFrames)
+    {
+        const size_t bytes = static_cast<size_t>(numFrames) * static_cast<size_t>(bytesPerSample(encoding));
+        for (int c = 0; c < numChannels; ++c)
+        {
+            storage[static_cast<size_t>(c)].assign(bytes, 0);
+            channelData[static_cast<size_t>(c)] = storage[static_cast<size_t>(c)].data();
+        }
+
+        juce::AudioBuffer<float> scratch(numChannels, juce::jmin(READ_CHUNK, juce::jmax(1, numFramesToRead)));
+        for (int start = 0; start < numFramesToRead; start += READ_CHUNK)
+        {
+            const int n = juce::jmin(READ_CHUNK, numFramesToRead - start);
+            reader.read(&scratch, 0, n, start, true, numChannels > 1);
+            for (int c = 0; c < numChannels; ++c)
+                encode(c, start, n, scratch.getReadPointer(c));
+        }
+    }
+
+    // Float data owned by someone else (e.g. a mapped bank); must outlive this view
+    static CompactSampleBuffer viewOf(const float* const* channels, int channelCount, int frames)
+    {
+        CompactSampleBuffer view;
+        view.numChannels = juce::jlimit(1, MAX_CHANNELS, channelCount);
+        view.numFrames = frames;
+        for (int c = 0; c < view.numChannels; ++c)
+            view.channelData[static_cast<size_t>(c)] = reinterpret_cast<const uint8_t*>(channels[c]);
+        return view;
+    }
+
+    Encoding getEncoding() const { return encoding; }
+    int getNumChannels() const { return numChannels; }
+    int getNumFrames() const { return numFrames; }
+
+    // Memory this buffer owns (views own none)
+    size_t getBytes() const
+    {
+        size_t total = 0;
+        for (const auto& s : storage)
+            total += s.size();
+        return total;
+    }
+
+    // Direct access for Float32 data, nullptr for integer encodings
+    const float* getFloatPointer(int channel) const
+    {
+        return encoding == Encoding::Float32 ? reinterpret_cast<const float*>(channelPointer(channel)) : nullptr;
+    }
+
+    float getSample(int channel, juce::int64 frame) const
+    {
+        const uint8_t* p = channelPointer(channel);
+        switch (encoding)
+        {
+            case Encoding::Int16:
+            {
+                int16_t v;
+                std::memcpy(&v, p + frame * 2, sizeof(v));
+                return static_cast<float>(v) * INT16_SCALE;
+            }
+            case Encoding::Int24:
+                return static_cast<float>(unpack24(p + frame * 3)) * INT24_SCALE;
+            case Encoding::Float32:
+                break;
+        }
+        return reinterpret_cast<const float*>(p)[frame];
+    }
+
+    // Frames [first, first + n) of one channel as float
+    void decode(int channel, juce::int64 first, int n, float* dest) const
+    {
+        const uint8_t* p = channelPointer(channel);
+        switch (encoding)
+        {
+            case Encoding::Int16:
+            {
+                const auto* src = reinterpret_cast<const int16_t*>(p) + first;
+                for (int i = 0; i < n; ++i)
+                    dest[i] = static_cast<float>(src[i]) * INT16_SCALE;
+                break;
+            }
+            case Encoding::Int24:
+            {
+                const uint8_t* src = p + first * 3;
+                for (int i = 0; i < n; ++i)
+                    dest[i] = static_cast<float>(unpack24(src + i * 3)) * INT24_SCALE;
+                break;
+            }
+            case Encoding::Float32:
+                std::memcpy(dest, reinterpret_cast<const float*>(p) + first, static_cast<size_t>(n) * sizeof(float));
+                break;
+        }
+    }
+
+private:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int READ_CHUNK = 16384;
+    static constexpr float INT16_SCALE = 1.0f / 32768.0f;
+    static constexpr float INT24_SCALE = 1.0f / 8388608.0f;
+
+    // Sign-extend a little-endian 24-bit word
+    static int32_t unpack24(const uint8_t* b)
+    {
+        const uint32_t u = (static_cast<uint32_t>(b[0]) << 8) | (static_cast<uint32_t>(b[1]) << 16) | (static_cast<uint32_t>(b[2]) << 24);
+        return static_cast<int32_t>(u) >> 8;
+    }
+
+    const uint8_t* channelPointer(int channel) const
+    {
+        return channelData[static_cast<size_t>(std::min(channel, numChannels - 1))];
+    }
+
+    void encode(int channel, int start, int n, const float* src)
+    {
+        uint8_t* dst = storage[static_cast<size_t>(channel)].data();
+        switch (encoding)
+        {
+            case Encoding::Int16:
+            {
+                auto* out = reinterpret_cast<int16_t*>(dst) + start;
+                for (int i = 0; i < n; ++i)
+                    out[i] = static_cast<int16_t>(juce::jlimit(-32768, 32767, juce::roundToInt(src[i] * 32768.0f)));
+                break;
+            }
+            case Encoding::Int24:
+            {
+                uint8_t* out = dst + static_cast<size_t>(start) * 3;
+                for (int i = 0; i < n; ++i)
+                {
+                    const int v = juce::jlimit(-8388608, 8388607, juce::roundToInt(static_cast<double>(src[i]) * 8388608.0));
+                    out[i * 3] = static_cast<uint8_t>(v);
+                    out[i * 3 + 1] = static_cast<uint8_t>(v >> 8);
+                    out[i * 3 + 2] = static_cast<uint8_t>(v >> 16);
+                }
+                break;
+            }
+            case Encoding::Float32:
+                std::memcpy(reinterpret_cast<float*>(dst) + start, src, static_cast<size_t>(n) * sizeof(float));
+                break;
+        }
+    }
+
+    Encoding encoding = Encoding::Float32;
+    int numChannels = 1;
+    int numFrames = 0;
+    std::array<const uint8_t*, MAX_CHANNELS> channelData {};
+    std::array<std::vector<uint8_t>, MAX_CHANNELS> storage;
+};
+
+} // namespace Engine
+} // namespace NulyBeats
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SamplePool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace NulyBeats {
+namespace Engine {
+
+/**
+ * The zones of one multisampled instrument, loaded on demand
+ *
+ * A zone starts as a stub: its file and key range, no audio. The first note
+ * that lands on a stub asks for it, and the loader fetches it from the
+ * SamplePool in the background. Until it arrives the note plays the nearest
+ * zone that is in memory, repitched. Every note also asks for the zones
+ * within PREFETCH_SEMITONES of it, closest first, so a part that moves
+ * around a region finds its zones already there.
+ *
+ * The audio thread only touches atomics here. Loaded zones stay in memory
+ * for the life of the instrument (the pool can still evict their full
+ * copies), so a voice may keep a raw pointer to one until its note ends.
+ */
+class LazyZoneMap
+{
+public:
+    static constexpr int PREFETCH_SEMITONES = 7;
+
+    struct ZoneInfo
+    {
+        juce::File file;
+        int rootNote = 60;
+        int lowKey = 0;
+        int highKey = 127;
+    };
+
+    LazyZoneMap(const std::vector<ZoneInfo>& infos, const SamplePool::LoadOptions& options)
+        : loadOptions(options),
+          zones(infos.size()),
+          unresolved(static_cast<int>(infos.size()))
+    {
+        for (size_t i = 0; i < infos.size(); ++i)
+            zones[i].info = infos[i];
+    }
+
+    int getNumZones() const { return static_cast<int>(zones.size()); }
+    const ZoneInfo& getZone(int index) const { return zones[static_cast<size_t>(index)].info; }
+
+    // As they were when the preset was loaded; later zones load the same way
+    const SamplePool::LoadOptions& getLoadOptions() const { return loadOptions; }
+
+    // The zone a preset should have before it plays: the one covering (or closest to) middle C
+    int findAnchorZone() const
+    {
+        int best = -1;
+        int bestDistance = std::numeric_limits<int>::max();
+        for (int i = 0; i < getNumZones(); ++i)
+        {
+            const auto& info = getZone(i);
+            const int distance = (60 >= info.lowKey && 60 <= info.highKey) ? -1 : std::abs(info.rootNote - 60);
+            if (distance < bestDistance)
+            {
+                best = i;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Audio thread: the sample a note on zone `index` should play, and the
+     * root note it was recorded at. Asks for the zone and its neighbours if
+     * they aren't in yet, and stands in with the nearest loaded zone
+     * meanwhile. nullptr if no zone has loaded.
+     */
+    PooledSample* resolve(int index, int midiNote, int& rootNote)
+    {
+        auto& zone = zones[static_cast<size_t>(index)];
+        raise(zone, Needed);
+        prefetchAround(midiNote);
+
+        if (auto* sample = zone.sample.load(std::memory_order_acquire))
+        {
+            rootNote = zone.info.rootNote;
+            return sample;
+        }
+
+        PooledSample* best = nullptr;
+        int bestDistance = std::numeric_limits<int>::max();
+        for (const auto& other : zones)
+        {
+            auto* sample = other.sample.load(std::memory_order_acquire);
+            const int distance = std::abs(other.info.rootNote - midiNote);
+            if (sample != nullptr && distance < bestDistance)
+            {
+                best = sample;
+                bestDistance = distance;
+                rootNote = other.info.rootNote;
+            }
+        }
+
+        return best;
+    }
+
+    // Ask for the zones near a note, without waiting for any of them
+    void prefetchAround(int midiNote)
+    {
+        lastNote.store(midiNote, std::memory_order_relaxed);
+        for (auto& zone : zones)
+            if (std::abs(zone.info.rootNote - midiNote) <= PREFETCH_SEMITONES)
+                raise(zone, Wanted);
+    }
+
+    // Audio thread: ask for every zone (offline rendering plays no stand-ins)
+    void requestAll()
+    {
+        for (auto& zone : zones)
+            raise(zone, Needed);
+    }
+
+    bool isFullyLoaded() const { return unresolved.load(std::memory_order_acquire) == 0; }
+
+    // True once per batch of requests: the loader should be woken
+    bool takeWakeUp() { return wakeUp.exchange(false, std::memory_order_acq_rel); }
+
+    /**
+     * Loader thread: zones to fetch next. Zones a note is waiting for come
+     * first, all at once; then prefetches, nearest the last note first, at
+     * most `maxPrefetch` of them.
+     */
+    std::vector<int> takeRequests(int maxPrefetch) const
+    {
+        std::vector<int> indices;
+        for (int i = 0; i < getNumZones(); ++i)
+            if (state(i) == Needed)
+                indices.push_back(i);
+
+        if (!indices.empty())
+            return indices;
+
+        for (int i = 0; i < getNumZones(); ++i)
+            if (state(i) == Wanted)
+                indices.push_back(i);
+
+        const int note = lastNote.load(std::memory_order_relaxed);
+        std::stable_sort(indices.begin(), indices.end(), [this, note](int a, int b) {
+            return std::abs(getZone(a).rootNote - note) < std::abs(getZone(b).rootNote - note);
+        });
+        if (static_cast<int>(indices.size()) > maxPrefetch)
+            indices.resize(static_cast<size_t>(juce::jmax(0, maxPrefetch)));
+        return indices;
+    }
+
+    // Loader thread: hand over a fetched zone (nullptr: the file can't be read)
+    void publish(int index, std::shared_ptr<PooledSample> sample)
+    {
+        auto& zone = zones[static_cast<size_t>(index)];
+        if (zone.state.load(std::memory_order_relaxed) >= Loaded)
+            return;
+
+        if (sample != nullptr)
+        {
+            zone.holder = std::move(sample);
+            zone.sample.store(zone.holder.get(), std::memory_order_release);
+        }
+        zone.state.store(zone.holder != nullptr ? Loaded : Failed, std::memory_order_release);
+        unresolved.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // nullptr while the zone is a stub
+    PooledSample* getLoadedSample(int index) const { return zones[static_cast<size_t>(index)].sample.load(std::memory_order_acquire); }
+
+private:
+    // Ordered: a request only ever raises a zone's state
+    enum ZoneState { Stub, Wanted, Needed, Loaded, Failed };
+
+    struct Zone
+    {
+        ZoneInfo info;
+        std::atomic<int> state { Stub };
+        std::atomic<PooledSample*> sample { nullptr };     // Published after `holder` is set
+        std::shared_ptr<PooledSample> holder;               // Loader thread only; set once
+    };
+
+    int state(int index) const { return zones[static_cast<size_t>(index)].state.load(std::memory_order_acquire); }
+
+    void raise(Zone& zone, int to)
+    {
+        int current = zone.state.load(std::memory_order_relaxed);
+        while (current < to)
+        {
+            if (zone.state.compare_exchange_weak(current, to, std::memory_order_acq_rel))
+            {
+                wakeUp.store(true, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    SamplePool::LoadOptions loadOptions;
+    std::vector<Zone> zones;
+    std::atomic<int> unresolved;
+    std::atomic<int> lastNote { 60 };
+    std::atomic<bool> wakeUp { false };
+};
+
+} // namespace Engine
+} // namespace NulyBeats
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace NulyBeats {
+namespace Engine {
+
+/**
+ * Packed sample bank: one file per sample category (".nbbank")
+ *
+ * Layout (all integers little-endian):
+ *   BankHeader
+ *   BankPresetEntry[numPresets]
+ *   BankZoneEntry[numZones]
+ *   string table (UTF-8, not terminated)
+ *   PCM data, every channel starting on a 64-byte boundary
+ *
+ * PCM is stored planar, ready to play. Each channel is followed by
+ * GUARD_FRAMES zeros so interpolators can read past the end. The whole file
+ * is memory-mapped, so loading a preset only resolves pointers. Pages come in
+ * from disk when a voice first touches them.
+ */
+namespace SampleBankFormat {
+
+static constexpr char MAGIC[8] = { 'N', 'B', 'S', 'B', 'A', 'N', 'K', '1' };
+static constexpr uint32_t VERSION = 1;
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+static constexpr uint64_t ALIGNMENT = 64;
+static constexpr int GUARD_FRAMES = 4;
+static constexpr const char* FILE_EXTENSION = ".nbbank";
+
+enum class SampleFormat : uint32_t
+{
+    Float32 = 0
+};
+
+struct BankHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t numPresets;
+    uint32_t numZones;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t dataOffset;
+    uint64_t fileSize;
+};
+
+struct BankPresetEntry
+{
+    uint32_t nameOffset;        // Into the string table
+    uint32_t nameLength;
+    uint32_t firstZone;
+    uint32_t numZones;
+    int32_t rootNote;
+    uint32_t flags;             // FLAG_MULTISAMPLED
+};
+
+struct BankZoneEntry
+{
+    uint32_t nameOffset;        // Source file name, for diagnostics
+    uint32_t nameLength;
+    int32_t rootNote;
+    int32_t lowKey;
+    int32_t highKey;
+    uint32_t numChannels;       // 1 or 2
+    uint32_t sampleFormat;      // SampleFormat
+    uint32_t reserved;
+    double sampleRate;
+    uint64_t numFrames;         // Excluding the guard frames
+    uint64_t channelOffset[2];  // Absolute file offsets, ALIGNMENT-aligned
+};
+
+static constexpr uint32_t FLAG_MULTISAMPLED = 1u << 0;
+
+static_assert(std::is_trivially_copyable_v<BankHeader> && sizeof(BankHeader) == 56);
+static_assert(std::is_trivially_copyable_v<BankPresetEntry> && sizeof(BankPresetEntry) == 24);
+static_assert(std::is_trivially_copyable_v<BankZoneEntry> && sizeof(BankZoneEntry) == 64);
+
+inline uint64_t alignUp(uint64_t offset) { return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+} // namespace SampleBankFormat
+
+/**
+ * Read-only view of a memory-mapped sample bank
+ * Every offset is validated on open, so the accessors never bounds-check.
+ */
+class SampleBank
+{
+public:
+    using Preset = SampleBankFormat::BankPresetEntry;
+    using Zone = SampleBankFormat::BankZoneEntry;
+
+    // Maps and validates a bank; nullptr if the file is missing or malformed
+    static std::shared_ptr<const SampleBank> open(const juce::File& file)
+    {
+        auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        if (mapped->getData() == nullptr)
+            return nullptr;
+
+        std::shared_ptr<SampleBank> bank(new SampleBank(file, std::move(mapped)));
+        if (!bank->validate())
+        {
+            DBG("Invalid sample bank: " + file.getFullPathName());
+            return nullptr;
+        }
+        return bank;
+    }
+
+    const juce::File& getFile() const { return file; }
+    juce::String getCategory() const { return file.getFileNameWithoutExtension(); }
+
+    int getNumPresets() const { return static_cast<int>(header().numPresets); }
+    const Preset& getPreset(int index) const { return presets()[index]; }
+    juce::String getPresetName(int index) const { return getString(getPreset(index).nameOffset, getPreset(index).nameLength); }
+
+    int findPreset(const juce::String& name) const
+    {
+        for (int i = 0; i < getNumPresets(); ++i)
+            if (getPresetName(i) == name)
+                return i;
+        return -1;
+    }
+
+    const Zone& getZone(int index) const { return zones()[index]; }
+    juce::String getZoneName(const Zone& zone) const { return getString(zone.nameOffset, zone.nameLength); }
+
+    // Planar PCM for one channel of a zone (mono zones return channel 0 for both)
+    const float* getChannelData(const Zone& zone, int channel) const
+    {
+        const auto c = static_cast<size_t>(juce::jmin(channel, static_cast<int>(zone.numChannels) - 1));
+        return reinterpret_cast<const float*>(base() + zone.channelOffset[c]);
+    }
+
+    size_t getMappedBytes() const { return mapped->getSize(); }
+
+private:
+    SampleBank(const juce::File& f, std::unique_ptr<juce::MemoryMappedFile> m)
+        : file(f), mapped(std::move(m))
+    {
+    }
+
+    const uint8_t* base() const { return static_cast<const uint8_t*>(mapped->getData()); }
+    const SampleBankFormat::BankHeader& header() const { return *reinterpret_cast<const SampleBankFormat::BankHeader*>(base()); }
+
+    const Preset* presets() const
+    {
+        return reinterpret_cast<const Preset*>(base() + sizeof(SampleBankFormat::BankHeader));
+    }
+
+    const Zone* zones() const
+    {
+        return reinterpret_cast<const Zone*>(base() + sizeof(SampleBankFormat::BankHeader)
+                                             + header().numPresets * sizeof(Preset));
+    }
+
+    juce::String getString(uint32_t offset, uint32_t length) const
+    {
+        return juce::String::fromUTF8(reinterpret_cast<const char*>(base() + header().stringTableOffset + offset),
+                                      static_cast<int>(length));
+    }
+
+    bool validate() const
+    {
+        using namespace SampleBankFormat;
+        const uint64_t size = mapped->getSize();
+
+        if (size < sizeof(BankHeader))
+            return false;
+
+        const auto& h = header();
+        if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION
+            || h.byteOrderMark != BYTE_ORDER_MARK || h.fileSize != size)
+            return false;
+
+        // Every bound below is checked in subtraction form: the fields come from
+        // the file, and a sum of them could wrap and pass
+        const uint64_t tablesEnd = sizeof(BankHeader) + uint64_t(h.numPresets) * sizeof(Preset)
+                                 + uint64_t(h.numZones) * sizeof(Zone);
+        if (h.dataOffset > size
+            || h.stringTableOffset > h.dataOffset
+            || tablesEnd > h.stringTableOffset
+            || h.stringTableSize > h.dataOffset - h.stringTableOffset)
+            return false;
+
+        auto stringOk = [&](uint32_t offset, uint32_t length) {
+            return uint64_t(offset) + length <= h.stringTableSize;
+        };
+
+        for (uint32_t i = 0; i < h.numPresets; ++i)
+        {
+            const auto& p = presets()[i];
+            if (!stringOk(p.nameOffset, p.nameLength) || uint64_t(p.firstZone) + p.numZones > h.numZones)
+                return false;
+        }
+
+        for (uint32_t i = 0; i < h.numZones; ++i)
+        {
+            const auto& z = zones()[i];
+            if (!stringOk(z.nameOffset, z.nameLength)
+                || z.numChannels < 1 || z.numChannels > 2
+                || z.sampleFormat != static_cast<uint32_t>(SampleFormat::Float32)
+                || z.numFrames == 0 || !(z.sampleRate > 0.0))
+                return false;
+
+            for (uint32_t c = 0; c < z.numChannels; ++c)
+            {
+                const uint64_t offset = z.channelOffset[c];
+                if (offset < h.dataOffset || offset > size || offset % ALIGNMENT != 0)
+                    return false;
+
+                const uint64_t framesAvailable = (size - offset) / sizeof(float);
+                if (framesAvailable < GUARD_FRAMES || z.numFrames > framesAvailable - GUARD_FRAMES)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> mapped;
+};
+
+/**
+ * Builds a bank file from decoded zones (offline tool side)
+ */
+class SampleBankWriter
+{
+public:
+    struct ZoneSource
+    {
+        juce::File file;
+        int rootNote = 60;
+        int lowKey = 0;
+        int highKey = 127;
+    };
+
+    struct PresetSource
+    {
+        juce::String name;
+        int rootNote = 60;
+        bool multisampled = false;
+        std::vector<ZoneSource> zones;
+    };
+
+    void addPreset(PresetSource preset) { presets.push_back(std::move(preset)); }
+
+    /**
+     * Decode every zone and write the bank. Zones that fail to decode are
+     * skipped (and reported through `errors`); presets left without zones are dropped.
+     */
+    bool write(const juce::File& destination, juce::StringArray* errors = nullptr)
+    {
+        using namespace SampleBankFormat;
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        // Pass 1: probe every file for its format, one reader open at a time
+        struct Probed { const ZoneSource* source; uint32_t numChannels; double sampleRate; uint64_t numFrames; };
+        std::vector<std::vector<Probed>> probed(presets.size());
+
+        for (size_t p = 0; p < presets.size(); ++p)
+        {
+            for (const auto& zone : presets[p].zones)
+            {
+                std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(zone.file));
+                if (reader == nullptr || reader->lengthInSamples <= 0)
+                {
+                    if (errors != nullptr)
+                        errors->add("Cannot read " + zone.file.getFullPathName());
+                    continue;
+                }
+
+                probed[p].push_back({ &zone, static_cast<uint32_t>(juce::jlimit(1, 2, static_cast<int>(reader->numChannels))),
+                                      reader->sampleRate, static_cast<uint64_t>(reader->lengthInSamples) });
+            }
+        }
+
+        // Tables and layout
+        std::vector<BankPresetEntry> presetTable;
+        std::vector<BankZoneEntry> zoneTable;
+        juce::MemoryOutputStream strings;
+
+        auto addString = [&strings](const juce::String& s, uint32_t& offset, uint32_t& length) {
+            offset = static_cast<uint32_t>(strings.getDataSize());
+            const auto utf8 = s.toRawUTF8();
+            length = static_cast<uint32_t>(std::strlen(utf8));
+            strings.write(utf8, length);
+        };
+
+        for (size_t p = 0; p < presets.size(); ++p)
+        {
+            if (probed[p].empty())
+                continue;
+
+            BankPresetEntry entry {};
+            addString(presets[p].name, entry.nameOffset, entry.nameLength);
+            entry.firstZone = static_cast<uint32_t>(zoneTable.size());
+            entry.numZones = static_cast<uint32_t>(probed[p].size());
+            entry.rootNote = presets[p].rootNote;
+            entry.flags = presets[p].multisampled ? FLAG_MULTISAMPLED : 0u;
+            presetTable.push_back(entry);
+
+            for (const auto& z : probed[p])
+            {
+                BankZoneEntry zone {};
+                addString(z.source->file.getFileName(), zone.nameOffset, zone.nameLength);
+                zone.rootNote = z.source->rootNote;
+                zone.lowKey = z.source->lowKey;
+                zone.highKey = z.source->highKey;
+                zone.numChannels = z.numChannels;
+                zone.sampleFormat = static_cast<uint32_t>(SampleFormat::Float32);
+                zone.sampleRate = z.sampleRate;
+                zone.numFrames = z.numFrames;
+                zoneTable.push_back(zone);
+            }
+        }
+
+        BankHeader header {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byteOrderMark = BYTE_ORDER_MARK;
+        header.numPresets = static_cast<uint32_t>(presetTable.size());
+        header.numZones = static_cast<uint32_t>(zoneTable.size());
+        header.stringTableOffset = sizeof(BankHeader) + presetTable.size() * sizeof(BankPresetEntry)
+                                 + zoneTable.size() * sizeof(BankZoneEntry);
+        header.stringTableSize = strings.getDataSize();
+        header.dataOffset = alignUp(header.stringTableOffset + header.stringTableSize);
+
+        uint64_t offset = header.dataOffset;
+        for (auto& zone : zoneTable)
+        {
+            for (uint32_t c = 0; c < zone.numChannels; ++c)
+            {
+                zone.channelOffset[c] = offset;
+                offset = alignUp(offset + (zone.numFrames + GUARD_FRAMES) * sizeof(float));
+            }
+        }
+        header.fileSize = offset;
+
+        // Write to a temporary file so a failed build never replaces a good bank
+        juce::TemporaryFile temp(destination);
+        {
+            juce::FileOutputStream out(temp.getFile());
+            if (!out.openedOk())
+                return false;
+
+            out.write(&header, sizeof(header));
+            out.write(presetTable.data(), presetTable.size() * sizeof(BankPresetEntry));
+            out.write(zoneTable.data(), zoneTable.size() * sizeof(BankZoneEntry));
+            out.write(strings.getData(), strings.getDataSize());
+
+            // Pass 2: decode in table order; zone entries line up with `probed`
+            size_t zoneIndex = 0;
+            for (const auto& zones : probed)
+            {
+                for (const auto& z : zones)
+                {
+                    const auto& entry = zoneTable[zoneIndex++];
+                    if (!writeZone(out, formatManager, *z.source, entry))
+                        return false;
+                }
+            }
+
+            padTo(out, header.fileSize);
+            out.flush();
+            if (out.getStatus().failed())
+                return false;
+        }
+
+        return temp.overwriteTargetFileWithTemporary();
+    }
+
+private:
+    static void padTo(juce::FileOutputStream& out, uint64_t position)
+    {
+        static constexpr char zeros[SampleBankFormat::ALIGNMENT] = {};
+        while (static_cast<uint64_t>(out.getPosition()) < position)
+            out.write(zeros, static_cast<size_t>(juce::jmin<uint64_t>(sizeof(zeros), position - static_cast<uint64_t>(out.getPosition()))));
+    }
+
+    static bool writeZone(juce::FileOutputStream& out, juce::AudioFormatManager& formatManager,
+                          const ZoneSource& source, const SampleBankFormat::BankZoneEntry& entry)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(source.file));
+        if (reader == nullptr)
+            return false;
+
+        const int numFrames = static_cast<int>(entry.numFrames);
+        juce::AudioBuffer<float> decoded(static_cast<int>(entry.numChannels), numFrames + SampleBankFormat::GUARD_FRAMES);
+        decoded.clear();
+        reader->read(&decoded, 0, numFrames, 0, true, entry.numChannels > 1);
+
+        for (int c = 0; c < decoded.getNumChannels(); ++c)
+        {
+            padTo(out, entry.channelOffset[c]);
+            out.write(decoded.getReadPointer(c), static_cast<size_t>(decoded.getNumSamples()) * sizeof(float));
+        }
+        return true;
+    }
+
+    std::vector<PresetSource> presets;
+};
+
+} // namespace Engine
+} // namespace NulyBeats
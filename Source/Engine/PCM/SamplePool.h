@@ -0,0 +1,542 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SampleStreamer.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NulyBeats {
+namespace Engine {
+
+/**
+ * A whole sample in memory, immutable once built
+ */
+struct ResidentSample
+{
+    static constexpr int GUARD_FRAMES = 4;  // Zeros after the end for the interpolator
+
+    CompactSampleBuffer data;               // length + GUARD_FRAMES frames
+    double sampleRate = 44100.0;
+    int length = 0;
+
+    size_t getBytes() const { return data.getBytes(); }
+};
+
+/**
+ * One file in the SamplePool, shared by every sound that plays it
+ *
+ * The head (StreamedSample) is always in memory. For short files it holds
+ * the whole sample. Longer files can also be fully resident; the pool may
+ * evict that copy under memory pressure and reload it later. Voices never
+ * see the difference: without the full copy they stream past the head.
+ *
+ * Voices bracket playback with beginUse()/endUse(). Both are lock-free. An
+ * evicted copy is only freed once no voice is inside that bracket.
+ */
+class PooledSample
+{
+public:
+    const StreamedSample& getHead() const { return *head; }
+    bool isShort() const { return head->getHeadFrames() >= head->getLength(); }
+
+    // Audio thread: a voice starts on this sample. Returns the full copy if resident.
+    const ResidentSample* beginUse()
+    {
+        activeVoices.fetch_add(1);
+        lastUsed.store(clock().load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        const auto* resident = full.load();
+        if (resident == nullptr && wantResident.load(std::memory_order_relaxed))
+            reloadRequested.store(true, std::memory_order_relaxed);
+        return resident;
+    }
+
+    // Audio thread: the voice has stopped reading
+    void endUse() { activeVoices.fetch_sub(1, std::memory_order_release); }
+
+    size_t getResidentBytes() const
+    {
+        const auto* resident = full.load(std::memory_order_relaxed);
+        return head->getResidentBytes() + (resident != nullptr ? resident->getBytes() : 0);
+    }
+
+private:
+    friend class SamplePool;
+
+    // Seconds since the pool started; ticked by the pool's maintenance thread
+    static std::atomic<juce::uint32>& clock()
+    {
+        static std::atomic<juce::uint32> seconds { 0 };
+        return seconds;
+    }
+
+    std::shared_ptr<const StreamedSample> head;
+
+    // The rest is guarded by SamplePool::mapMutex, apart from the atomics
+    std::atomic<const ResidentSample*> full { nullptr };
+    std::unique_ptr<ResidentSample> owned;      // Backs `full`
+    std::unique_ptr<ResidentSample> retired;    // Evicted, freed once no voice uses it
+    std::atomic<int> activeVoices { 0 };
+    std::atomic<juce::uint32> lastUsed { 0 };
+    std::atomic<bool> wantResident { false };
+    std::atomic<bool> reloadRequested { false };
+};
+
+/**
+ * Process-wide pool of decoded samples, shared by every plugin instance
+ *
+ * Entries are keyed by file path, modification time, size and preload length,
+ * so an edited file gets a fresh entry. The pool only holds weak references:
+ * instances share one copy for as long as any of them uses it, and the last
+ * release frees it. Lookups for different files run in parallel; a second
+ * request for a file that is still decoding waits for it.
+ *
+ * Fully resident copies count against a global memory budget. A maintenance
+ * thread evicts the least recently triggered ones when the budget is
+ * exceeded (and, optionally, any not triggered for a while). It reloads an
+ * evicted copy in the background when it is played again and fits.
+ *
+ * Obtain it through juce::SharedResourcePointer<SamplePool>. Entries must
+ * not outlive the pool.
+ */
+class SamplePool
+{
+public:
+    struct LoadOptions
+    {
+        bool streaming = true;                  // false: keep whole files resident (within budget)
+        float preloadMs = SampleStreamer::DEFAULT_PRELOAD_MS;
+        double maxResidentSeconds = 30.0;       // Longer files always stream
+        bool compact = true;                    // Keep 16/24-bit sources at their own width (lossless)
+    };
+
+    SamplePool()
+        : decoders(juce::jmax(1, juce::SystemStats::getNumCpus())),
+          maintenance(*this)
+    {
+        formatManager.registerBasicFormats();
+        maintenanceFormats.registerBasicFormats();
+        memoryBudget = static_cast<size_t>(juce::jmax(1024, juce::SystemStats::getMemorySizeInMegabytes() / 4)) << 20;
+        maintenance.startThread(juce::Thread::Priority::low);
+    }
+
+    ~SamplePool()
+    {
+        maintenance.stopThread(2000);
+    }
+
+    // nullptr if the file can't be read
+    std::shared_ptr<PooledSample> acquire(const juce::File& file, const LoadOptions& options)
+    {
+        const auto key = makeKey(file, options);
+
+        std::shared_ptr<Slot> slot;
+        {
+            const std::lock_guard<std::mutex> lock(mapMutex);
+            purgeExpired();
+
+            auto& entry = slots[key];
+            if (entry == nullptr)
+                entry = std::make_shared<Slot>();
+            slot = entry;
+        }
+
+        const std::lock_guard<std::mutex> slotLock(slot->mutex);
+
+        auto sample = slot->sample.lock();
+        if (sample != nullptr)
+        {
+            hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            sample = loadHead(file, options);
+            if (sample == nullptr)
+                return nullptr;
+
+            const std::lock_guard<std::mutex> lock(mapMutex);
+            slot->sample = sample;
+        }
+
+        if (!options.streaming && !sample->isShort()
+            && sample->getHead().getLength() <= static_cast<juce::int64>(options.maxResidentSeconds * sample->getHead().getSampleRate()))
+        {
+            sample->wantResident.store(true, std::memory_order_relaxed);
+            if (sample->full.load() == nullptr)
+                makeResident(*sample);
+        }
+
+        return sample;
+    }
+
+    /**
+     * acquire() for several files at once, spread over the decoder threads
+     * (the calling thread decodes too). Results line up with `files`; an entry
+     * is nullptr if its file can't be read or `shouldStop` returned true
+     * before it was started. onProgress(filesDone) may be called from any of
+     * the threads involved.
+     */
+    std::vector<std::shared_ptr<PooledSample>> acquireAll(const std::vector<juce::File>& files, const LoadOptions& options,
+                                                          const std::function<bool()>& shouldStop = {},
+                                                          const std::function<void(int)>& onProgress = {})
+    {
+        const int count = static_cast<int>(files.size());
+        std::vector<std::shared_ptr<PooledSample>> results(files.size());
+
+        // Largest files first, so one long zone doesn't start last and hold up the rest
+        std::vector<std::pair<juce::int64, size_t>> order;
+        order.reserve(files.size());
+        for (size_t i = 0; i < files.size(); ++i)
+            order.push_back({ files[i].getSize(), i });
+        std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        std::atomic<int> next { 0 };
+        std::atomic<int> done { 0 };
+        const std::function<void()> work = [&]
+        {
+            for (int k = next.fetch_add(1); k < count; k = next.fetch_add(1))
+            {
+                if (shouldStop && shouldStop())
+                    continue;
+
+                const auto i = order[static_cast<size_t>(k)].second;
+                results[i] = acquire(files[i], options);
+                const int n = done.fetch_add(1) + 1;
+                if (onProgress)
+                    onProgress(n);
+            }
+        };
+
+        // The decoder threads are shared by every instance. Once the files have
+        // run out, helpers still queued behind another instance's load are
+        // taken back rather than waited for; only running ones are waited on.
+        const int numHelpers = juce::jmin(count - 1, decoders.getNumThreads());
+        std::vector<std::unique_ptr<DecodeHelper>> helpers;
+        helpers.reserve(static_cast<size_t>(juce::jmax(0, numHelpers)));
+
+        for (int h = 0; h < numHelpers; ++h)
+        {
+            helpers.push_back(std::make_unique<DecodeHelper>(work));
+            decoders.addJob(helpers.back().get(), false);
+        }
+
+        work();
+        for (auto& helper : helpers)
+            decoders.removeJob(helper.get(), false, -1);
+
+        return results;
+    }
+
+    /**
+     * Ceiling for sample memory across all instances (heads plus resident
+     * copies). Heads are never evicted; resident copies are.
+     */
+    void setMemoryBudget(size_t bytes)
+    {
+        memoryBudget.store(bytes, std::memory_order_relaxed);
+        maintenance.wakeUp.signal();
+    }
+
+    // Also evict resident copies not triggered for this long (0 = only under pressure)
+    void setIdleEvictionSeconds(int seconds) { idleEvictionSeconds.store(juce::jmax(0, seconds), std::memory_order_relaxed); }
+
+    size_t getMemoryBudget() const { return memoryBudget.load(std::memory_order_relaxed); }
+    size_t getResidentBytes() const { return residentBytes.load(std::memory_order_relaxed); }
+    juce::uint64 getEvictionCount() const { return evictions.load(std::memory_order_relaxed); }
+    juce::uint64 getReloadCount() const { return reloads.load(std::memory_order_relaxed); }
+    juce::uint64 getHitCount() const { return hits.load(std::memory_order_relaxed); }
+    juce::uint64 getMissCount() const { return misses.load(std::memory_order_relaxed); }
+
+    int getNumLiveSamples() const
+    {
+        const std::lock_guard<std::mutex> lock(mapMutex);
+        int n = 0;
+        for (const auto& [key, slot] : slots)
+            n += slot->sample.expired() ? 0 : 1;
+        return n;
+    }
+
+private:
+    struct Slot
+    {
+        std::mutex mutex;   // Held while decoding, so concurrent requests share the result
+        std::weak_ptr<PooledSample> sample;     // Written under both locks, read under either
+    };
+
+    // One acquireAll() helper on the shared decoder threads
+    class DecodeHelper : public juce::ThreadPoolJob
+    {
+    public:
+        explicit DecodeHelper(const std::function<void()>& w) : juce::ThreadPoolJob("Sample decode"), work(w) {}
+
+        JobStatus runJob() override
+        {
+            work();
+            return jobHasFinished;
+        }
+
+    private:
+        const std::function<void()>& work;
+    };
+
+    class Maintenance : public juce::Thread
+    {
+    public:
+        explicit Maintenance(SamplePool& o) : juce::Thread("Sample pool"), owner(o) {}
+
+        void run() override
+        {
+            const auto start = juce::Time::getMillisecondCounter();
+            while (!threadShouldExit())
+            {
+                wakeUp.wait(PASS_INTERVAL_MS);
+                PooledSample::clock().store((juce::Time::getMillisecondCounter() - start) / 1000, std::memory_order_relaxed);
+                owner.maintain();
+            }
+        }
+
+        juce::WaitableEvent wakeUp;
+
+    private:
+        static constexpr int PASS_INTERVAL_MS = 250;
+        SamplePool& owner;
+    };
+
+    static juce::String makeKey(const juce::File& file, const LoadOptions& options)
+    {
+        return file.getFullPathName()
+             + "|" + juce::String(file.getLastModificationTime().toMilliseconds())
+             + "|" + juce::String(file.getSize())
+             + "|" + juce::String(juce::roundToInt(options.preloadMs))
+             + (options.compact ? "|c" : "");
+    }
+
+    std::shared_ptr<PooledSample> loadHead(const juce::File& file, const LoadOptions& options)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+        {
+            DBG("SamplePool: failed to read " + file.getFullPathName());
+            return nullptr;
+        }
+
+        auto sample = std::shared_ptr<PooledSample>(new PooledSample(), [this](PooledSample* s) { release(s); });
+        const auto encoding = options.compact ? CompactSampleBuffer::nativeEncodingFor(*reader)
+                                              : CompactSampleBuffer::Encoding::Float32;
+        sample->head = std::make_shared<StreamedSample>(
+            file, *reader, SampleStreamer::preloadFramesFor(reader->sampleRate, options.preloadMs), encoding);
+        residentBytes.fetch_add(sample->head->getResidentBytes(), std::memory_order_relaxed);
+        return sample;
+    }
+
+    static std::unique_ptr<ResidentSample> decodeWhole(juce::AudioFormatManager& formats, const StreamedSample& head)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(head.getFile()));
+        if (reader == nullptr)
+            return nullptr;
+
+        // Same width as the head
+        auto resident = std::make_unique<ResidentSample>();
+        resident->sampleRate = reader->sampleRate;
+        resident->length = static_cast<int>(head.getLength());
+        resident->data = CompactSampleBuffer(*reader, head.getNumChannels(), resident->length,
+                                             resident->length + ResidentSample::GUARD_FRAMES, head.getHead().getEncoding());
+        return resident;
+    }
+
+    // Load a full copy now (acquire path; the slot lock keeps this single per sample)
+    void makeResident(PooledSample& sample)
+    {
+        // The bytes are claimed before decoding, so parallel acquires can't all
+        // squeeze under the budget. Over budget it streams; its first note asks
+        // the maintenance thread for a copy.
+        const size_t reserved = fullBytes(sample);
+        size_t current = residentBytes.load(std::memory_order_relaxed);
+        do
+        {
+            if (current + reserved > memoryBudget.load(std::memory_order_relaxed))
+                return;
+        }
+        while (!residentBytes.compare_exchange_weak(current, current + reserved, std::memory_order_relaxed));
+
+        auto resident = decodeWhole(formatManager, sample.getHead());
+        if (resident == nullptr)
+        {
+            residentBytes.fetch_sub(reserved, std::memory_order_relaxed);
+            return;
+        }
+
+        install(sample, std::move(resident), reserved);
+    }
+
+    // `reserved`: bytes already added to residentBytes for this copy
+    void install(PooledSample& sample, std::unique_ptr<ResidentSample> resident, size_t reserved = 0)
+    {
+        const std::lock_guard<std::mutex> lock(mapMutex);
+        residentBytes.fetch_sub(reserved, std::memory_order_relaxed);
+        if (sample.owned != nullptr)
+            return;
+
+        residentBytes.fetch_add(resident->getBytes(), std::memory_order_relaxed);
+        sample.lastUsed.store(PooledSample::clock().load(std::memory_order_relaxed), std::memory_order_relaxed);   // Not the idlest copy yet
+        sample.owned = std::move(resident);
+        sample.full.store(sample.owned.get());
+        sample.reloadRequested.store(false, std::memory_order_relaxed);
+    }
+
+    // Custom deleter: the last sound has let go
+    void release(PooledSample* sample)
+    {
+        size_t bytes = sample->head->getResidentBytes();
+        if (sample->owned != nullptr)
+            bytes += sample->owned->getBytes();
+        if (sample->retired != nullptr)
+            bytes += sample->retired->getBytes();
+        residentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        delete sample;
+    }
+
+    // Maintenance thread: free, evict, reload
+    void maintain()
+    {
+        std::vector<std::shared_ptr<PooledSample>> live;
+        std::vector<PooledSample*> toReload;
+        {
+            const std::lock_guard<std::mutex> lock(mapMutex);
+            for (const auto& [key, slot] : slots)
+                if (auto sample = slot->sample.lock())
+                    live.push_back(std::move(sample));
+
+            freeRetired(live);
+
+            // Recently played zones that lost their copy come back first, at the expense of colder ones
+            size_t reserve = 0;
+            for (const auto& sample : live)
+            {
+                if (sample->reloadRequested.exchange(false, std::memory_order_relaxed)
+                    && sample->owned == nullptr && sample->retired == nullptr)
+                {
+                    toReload.push_back(sample.get());
+                    reserve += fullBytes(*sample);
+                }
+            }
+
+            evict(live, reserve);
+        }
+
+        for (auto* sample : toReload)
+        {
+            if (residentBytes.load(std::memory_order_relaxed) + fullBytes(*sample) > memoryBudget.load(std::memory_order_relaxed))
+                continue;   // Keeps streaming; tried again next time it is played
+
+            if (auto resident = decodeWhole(maintenanceFormats, *sample->head))
+            {
+                install(*sample, std::move(resident));
+                reloads.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // `live` may hold the last reference; releasing it here is off the audio thread
+    }
+
+    static size_t fullBytes(const PooledSample& sample)
+    {
+        return static_cast<size_t>(sample.head->getNumChannels())
+             * static_cast<size_t>(sample.head->getLength() + ResidentSample::GUARD_FRAMES)
+             * static_cast<size_t>(CompactSampleBuffer::bytesPerSample(sample.head->getHead().getEncoding()));
+    }
+
+    // Called with mapMutex held
+    void freeRetired(const std::vector<std::shared_ptr<PooledSample>>& live)
+    {
+        for (const auto& sample : live)
+        {
+            if (sample->retired != nullptr && sample->activeVoices.load() == 0)
+            {
+                residentBytes.fetch_sub(sample->retired->getBytes(), std::memory_order_relaxed);
+                sample->retired.reset();
+            }
+        }
+    }
+
+    /**
+     * Drop full copies, least recently triggered first, until `reserve` more
+     * bytes fit in the budget; also drop idle ones. Zones that are playing
+     * are skipped - their memory couldn't be freed yet anyway. Called with
+     * mapMutex held.
+     */
+    void evict(const std::vector<std::shared_ptr<PooledSample>>& live, size_t reserve)
+    {
+        const auto now = PooledSample::clock().load(std::memory_order_relaxed);
+        const auto idleLimit = static_cast<juce::uint32>(idleEvictionSeconds.load(std::memory_order_relaxed));
+        const auto budget = memoryBudget.load(std::memory_order_relaxed);
+
+        std::vector<PooledSample*> candidates;
+        for (const auto& sample : live)
+            if (sample->owned != nullptr && sample->activeVoices.load() == 0)
+                candidates.push_back(sample.get());
+
+        std::sort(candidates.begin(), candidates.end(), [](const PooledSample* a, const PooledSample* b) {
+            return a->lastUsed.load(std::memory_order_relaxed) < b->lastUsed.load(std::memory_order_relaxed);
+        });
+
+        for (auto* sample : candidates)
+        {
+            const bool overBudget = residentBytes.load(std::memory_order_relaxed) + reserve > budget;
+            const bool idle = idleLimit > 0 && now - sample->lastUsed.load(std::memory_order_relaxed) > idleLimit;
+            if (!overBudget && !idle)
+                continue;
+
+            // A voice may have started on it since the check: it keeps the copy
+            // until it stops, and the next pass frees it. New voices stream.
+            sample->full.store(nullptr);
+            sample->retired = std::move(sample->owned);
+            evictions.fetch_add(1, std::memory_order_relaxed);
+
+            if (sample->activeVoices.load() == 0)
+            {
+                residentBytes.fetch_sub(sample->retired->getBytes(), std::memory_order_relaxed);
+                sample->retired.reset();
+            }
+        }
+    }
+
+    // Drop map entries nobody holds any more (called with mapMutex held)
+    void purgeExpired()
+    {
+        for (auto it = slots.begin(); it != slots.end();)
+        {
+            const bool inUse = it->second.use_count() > 1;    // A loader is working on it
+            if (!inUse && it->second->sample.expired())
+                it = slots.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    juce::AudioFormatManager formatManager;         // Shared by every acquire(); readers are per call
+    juce::AudioFormatManager maintenanceFormats;    // Maintenance thread only
+
+    mutable std::mutex mapMutex;
+    std::map<juce::String, std::shared_ptr<Slot>> slots;
+
+    std::atomic<size_t> memoryBudget { 0 };
+    std::atomic<size_t> residentBytes { 0 };
+    std::atomic<int> idleEvictionSeconds { 0 };
+
+    std::atomic<juce::uint64> hits { 0 };
+    std::atomic<juce::uint64> misses { 0 };
+    std::atomic<juce::uint64> evictions { 0 };
+    std::atomic<juce::uint64> reloads { 0 };
+
+    juce::ThreadPool decoders;      // acquireAll() helpers, one per core
+    Maintenance maintenance;
+};
+
+} // namespace Engine
+} // namespace NulyBeats
@@ -2,18 +2,33 @@
 
 #include <JuceHeader.h>
 #include "SampleZone.h"
+#include "SampleBank.h"
+#include <functional>
 #include <memory>
 #include <map>
+#include <optional>
 #include <set>
+#include <unordered_map>
+#include <utility>
+
+#if JUCE_LINUX
+ #include <poll.h>
+ #include <sys/inotify.h>
+ #include <unistd.h>
+#endif
 
 namespace NulyBeats {
 namespace Engine {
 
 /**
  * Manages sample-based presets
- * Loads samples from Resources/Samples/ and organizes them by category
+ * Loads samples from Resources/Samples/ and organizes them by category.
+ * A packed bank (Samples/<Category>.nbbank) takes the place of the
+ * category's folder of WAVs. The folder layout is cached in a binary index
+ * so instances start without walking the whole library; on Linux the folders
+ * are then watched and edits are applied as they happen.
  */
-class SamplePresetManager
+class SamplePresetManager : private juce::AsyncUpdater
 {
 public:
     // Represents a single sample zone within a multisampled preset
@@ -34,193 +49,79 @@ public:
         bool loopEnabled = false;
         bool isMultisampled = false;    // True if this has multiple samples
         std::vector<SampleZoneInfo> zones;  // All sample zones for multisampled presets
+        juce::int64 id = 0;             // makePresetId(category, name), stable across scans
+
+        // Set when the preset lives in a packed bank (sampleFile is then the bank)
+        std::shared_ptr<const SampleBank> bank;
+        int bankPresetIndex = -1;
     };
 
     SamplePresetManager() = default;
 
-    void scanSampleDirectory(const juce::File& resourceDir)
+    ~SamplePresetManager() override
     {
-        presets.clear();
-        categories.clear();
-
-        auto samplesDir = resourceDir.getChildFile("Samples");
-        if (!samplesDir.exists())
-            return;
-
-        // Scan each category folder
-        for (const auto& categoryDir : samplesDir.findChildFiles(juce::File::findDirectories, false))
-        {
-            juce::String category = categoryDir.getFileName();
-            categories.push_back(category);
-
-            // Scan subdirectories for multisampled presets
-            auto subDirs = categoryDir.findChildFiles(juce::File::findDirectories, false);
-
-            // Process each subdirectory as a multisampled preset
-            for (const auto& presetDir : subDirs)
-            {
-                    auto wavFiles = presetDir.findChildFiles(juce::File::findFiles, false, "*.wav");
-                    if (wavFiles.isEmpty())
-                        continue;
-
-                    SamplePreset preset;
-                    preset.name = presetDir.getFileName();
-                    preset.category = category;
-                    preset.isMultisampled = true;
-
-                    // Collect all samples with their MIDI notes
-                    std::vector<std::pair<int, juce::File>> notesAndFiles;
-
-                    juce::String presetFolderName = presetDir.getFileName();
+        rescanner.stopThread(10000);
+        stopWatching();
+        cancelPendingUpdate();
+    }
 
-                    // First pass: count unique base names to detect if folder has mixed presets
-                    std::set<juce::String> uniqueBaseNames;
-                    for (const auto& wav : wavFiles)
-                    {
-                        juce::String fileName = wav.getFileNameWithoutExtension();
-                        int msIndex = fileName.indexOf("_ms0_");
-                        juce::String baseName = (msIndex > 0) ? fileName.substring(0, msIndex) : fileName;
-                        uniqueBaseNames.insert(baseName.toLowerCase());
-                    }
+    // Full synchronous walk of every folder; usePackedBanks = false scans only
+    // the WAV folders (used by the bank builder)
+    void scanSampleDirectory(const juce::File& resourceDir, bool usePackedBanks = true)
+    {
+        rescanner.stopThread(10000);
+        stopWatching();
+        samplesDir = resourceDir.getChildFile("Samples");
+        indexFile = juce::File();
 
-                    // If all files share the same base name, include them all
-                    // (handles cases like "First Choice" folder with "Init Patch" samples)
-                    bool allSameBaseName = (uniqueBaseNames.size() == 1);
+        openBanks(usePackedBanks);
+        library = scanLibrary(samplesDir, nullptr, bankCategories, nullptr);
+        rebuild();
+    }
 
-                    for (const auto& wav : wavFiles)
-                    {
-                        juce::String fileName = wav.getFileNameWithoutExtension();
-
-                        // If all files have the same base name, include them all
-                        // Otherwise, filter to only include files matching the folder name
-                        bool belongsToPreset = allSameBaseName;
-
-                        if (!allSameBaseName)
-                        {
-                            // Extract the base name from the wav file (before _ms0_XXX_)
-                            int msIndex = fileName.indexOf("_ms0_");
-                            juce::String baseName = (msIndex > 0) ? fileName.substring(0, msIndex) : fileName;
-
-                            // Remove common prefixes like "A001 ", "F018 " etc
-                            if (baseName.length() > 5 && baseName[4] == ' ')
-                            {
-                                bool hasPrefix = true;
-                                for (int c = 0; c < 4; ++c)
-                                {
-                                    char ch = baseName[c];
-                                    if (!((ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')))
-                                        hasPrefix = false;
-                                }
-                                if (hasPrefix)
-                                    baseName = baseName.substring(5);
-                            }
-
-                            // Check if folder name matches the cleaned base name
-                            if (presetFolderName.equalsIgnoreCase(baseName) ||
-                                presetFolderName.containsIgnoreCase(baseName) ||
-                                baseName.containsIgnoreCase(presetFolderName))
-                            {
-                                belongsToPreset = true;
-                            }
-
-                            // Skip generic "Init Patch" samples when mixed with other samples
-                            if (fileName.startsWithIgnoreCase("Init Patch"))
-                                belongsToPreset = false;
-                        }
-
-                        if (!belongsToPreset)
-                            continue;
-
-                        // Parse note from filename like "ShapeURMusic_ms0_060_c3.wav"
-                        // or "Init Patch_ms0_060_c3.wav"
-                        juce::String name = fileName;
-
-                        // Look for _XXX_ pattern where XXX is MIDI note number
-                        int lastUnderscore = name.lastIndexOf("_");
-                        if (lastUnderscore > 0)
-                        {
-                            // Find second-to-last underscore by searching in substring
-                            juce::String beforeLast = name.substring(0, lastUnderscore);
-                            int secondLastUnderscore = beforeLast.lastIndexOf("_");
-                            if (secondLastUnderscore >= 0)
-                            {
-                                juce::String noteStr = name.substring(secondLastUnderscore + 1, lastUnderscore);
-                                int midiNote = noteStr.getIntValue();
-                                if (midiNote >= 21 && midiNote <= 108)
-                                {
-                                    notesAndFiles.push_back({midiNote, wav});
-                                }
-                            }
-                        }
-                    }
+    /**
+     * Fast startup path: the preset list comes from the on-disk index if it
+     * was written for this Samples folder, and a background pass then re-lists
+     * only the folders whose modification time changed. A changed library is
+     * rewritten to the index and swapped in on the message thread.
+     * Without a usable index this does a full scan and writes one.
+     * Either way the folders are watched afterwards (Linux).
+     * Returns true if the index was used.
+     */
+    bool loadIndex(const juce::File& indexFileToUse, const juce::File& resourceDir)
+    {
+        rescanner.stopThread(10000);
+        stopWatching();
+        samplesDir = resourceDir.getChildFile("Samples");
+        indexFile = indexFileToUse;
 
-                    // Sort by MIDI note
-                    std::sort(notesAndFiles.begin(), notesAndFiles.end(),
-                        [](const auto& a, const auto& b) { return a.first < b.first; });
+        openBanks(true);
+        if (auto indexed = readIndex(indexFile, samplesDir))
+        {
+            library = std::move(*indexed);
+            rebuild();
+            rescanner.start(indexFile.getLastModificationTime());
+            return true;
+        }
 
-                    // Calculate key ranges for each sample
-                    // Each sample covers from halfway to previous sample to halfway to next sample
-                    for (size_t i = 0; i < notesAndFiles.size(); ++i)
-                    {
-                        SampleZoneInfo zone;
-                        zone.sampleFile = notesAndFiles[i].second;
-                        zone.rootNote = notesAndFiles[i].first;
-
-                        // Calculate low key (halfway between this and previous sample)
-                        if (i == 0)
-                            zone.lowKey = 0;  // First sample covers from bottom
-                        else
-                            zone.lowKey = (notesAndFiles[i-1].first + notesAndFiles[i].first) / 2 + 1;
-
-                        // Calculate high key (halfway between this and next sample)
-                        if (i == notesAndFiles.size() - 1)
-                            zone.highKey = 127;  // Last sample covers to top
-                        else
-                            zone.highKey = (notesAndFiles[i].first + notesAndFiles[i+1].first) / 2;
-
-                        preset.zones.push_back(zone);
-                    }
+        library = scanLibrary(samplesDir, nullptr, bankCategories, nullptr);
+        if (samplesDir.isDirectory())
+        {
+            writeIndex(indexFile, samplesDir, library);
+            startWatching(library);
+        }
+        rebuild();
+        return false;
+    }
 
-                    // Also set the main sampleFile to C4 or closest for backwards compat
-                    if (!notesAndFiles.empty())
-                    {
-                        int bestIdx = 0;
-                        int bestDist = std::abs(notesAndFiles[0].first - 60);
-                        for (size_t i = 1; i < notesAndFiles.size(); ++i)
-                        {
-                            int dist = std::abs(notesAndFiles[i].first - 60);
-                            if (dist < bestDist)
-                            {
-                                bestDist = dist;
-                                bestIdx = static_cast<int>(i);
-                            }
-                        }
-                        preset.sampleFile = notesAndFiles[bestIdx].second;
-                        preset.rootNote = notesAndFiles[bestIdx].first;
-                    }
+    // Also true once the rescan has finished until its result is applied
+    bool isRescanning() const { return rescanner.isThreadRunning() || rescanFinished.load(std::memory_order_acquire); }
 
-                    presets.push_back(preset);
-            }
+    // Bumped every time the preset list is rebuilt; the browser polls it
+    juce::uint32 getLibraryVersion() const { return libraryVersion.load(std::memory_order_acquire); }
 
-            // Also scan for loose wav files directly in the category folder
-            // This handles single-sample presets like Moog Bass
-            for (const auto& sampleFile : categoryDir.findChildFiles(juce::File::findFiles, false, "*.wav;*.mp3;*.aif;*.aiff"))
-            {
-                SamplePreset preset;
-                preset.name = sampleFile.getFileNameWithoutExtension();
-                preset.category = category;
-                preset.sampleFile = sampleFile;
-
-                // Set default root note based on category
-                if (category == "Bass" || category == "Synth Bass" || category == "Moog Bass" || category.containsIgnoreCase("Bass"))
-                    preset.rootNote = 36;  // C2 for bass sounds
-                else
-                    preset.rootNote = 60;  // C4 for everything else
-
-                presets.push_back(preset);
-            }
-        }
-    }
+    // Message thread: called when a background rescan's result has been applied
+    std::function<void()> onRescanFinished;
 
     const std::vector<juce::String>& getCategories() const { return categories; }
 
@@ -299,20 +200,1034 @@ public:
         return instrument;
     }
 
-    // Find preset by name
+    // Find preset by name (the first one wins if a name appears in several categories).
+    // Pointers stay valid until the library is next rebuilt on the message thread.
     const SamplePreset* findPreset(const juce::String& name) const
     {
-        for (const auto& preset : presets)
+        auto it = presetsByName.find(name);
+        return it != presetsByName.end() ? &presets[it->second] : nullptr;
+    }
+
+    const SamplePreset* findPresetById(juce::int64 id) const
+    {
+        auto it = presetsById.find(id);
+        return it != presetsById.end() ? &presets[it->second] : nullptr;
+    }
+
+    static juce::int64 makePresetId(const juce::String& category, const juce::String& name)
+    {
+        return (category + "/" + name).hashCode64();
+    }
+
+private:
+    // One preset subfolder; presets is empty when it holds no usable WAVs
+    struct FolderRecord
+    {
+        juce::String name;
+        juce::int64 modified = 0;
+        std::vector<SamplePreset> presets;
+    };
+
+    struct CategoryRecord
+    {
+        juce::String name;
+        juce::int64 modified = 0;
+        std::vector<FolderRecord> folders;
+        std::vector<SamplePreset> loosePresets;
+    };
+
+    using Library = std::vector<CategoryRecord>;
+
+    static constexpr int INDEX_MAGIC = 0x5849424e;    // "NBIX"
+    static constexpr int INDEX_VERSION = 1;
+    static constexpr int MAX_INDEX_COUNT = 1 << 20;   // Sanity bound when reading counts
+
+    /**
+     * Brings an index up to date off the message thread. A directory's
+     * modification time changes when entries are added, removed or renamed,
+     * so unchanged folders keep their records without listing their files.
+     */
+    class Rescanner : public juce::Thread
+    {
+    public:
+        explicit Rescanner(SamplePresetManager& o) : juce::Thread("Sample library rescan"), owner(o) {}
+
+        ~Rescanner() override { stopThread(10000); }
+
+        void start(juce::Time indexTimeAtLoad)
+        {
+            previous = owner.library;
+            samplesDir = owner.samplesDir;
+            indexFile = owner.indexFile;
+            skip = owner.bankCategories;
+            indexTime = indexTimeAtLoad;
+            startThread(juce::Thread::Priority::low);
+        }
+
+        void run() override
+        {
+            // Instances opened together queue here; the first refreshes the
+            // index and the rest just re-read it. Polled, so a queued instance
+            // can still be stopped.
+            static juce::CriticalSection processWideLock;
+            while (!threadShouldExit())
+            {
+                const juce::ScopedTryLock sl(processWideLock);
+                if (sl.isLocked())
+                {
+                    refresh();
+                    return;
+                }
+                wait(50);
+            }
+        }
+
+    private:
+        void refresh()
+        {
+            std::optional<Library> result;
+            if (indexFile.getLastModificationTime() != indexTime)
+                result = readIndex(indexFile, samplesDir);
+
+            if (!result)
+            {
+                result = scanLibrary(samplesDir, &previous, skip, this);
+                if (threadShouldExit())
+                    return;
+
+                if (!sameLayout(*result, previous))
+                    writeIndex(indexFile, samplesDir, *result);
+            }
+
+            if (threadShouldExit())
+                return;
+
+            if (!sameLayout(*result, previous))
+                owner.receiveLibrary(std::make_unique<Library>(*result));
+
+            owner.rescanFinished.store(true, std::memory_order_release);
+            owner.triggerAsyncUpdate();
+
+            // Queued after our result, so a newer copy the watcher already holds wins
+            owner.startWatching(*result);
+        }
+
+        SamplePresetManager& owner;
+        Library previous;
+        juce::File samplesDir;
+        juce::File indexFile;
+        std::vector<juce::String> skip;
+        juce::Time indexTime;
+    };
+
+   #if JUCE_LINUX
+    /**
+     * One inotify instance per process, shared by every manager. A Samples
+     * folder is watched once (root, categories and preset folders) however
+     * many instances use it. Events are collected until the folder has been
+     * quiet for a moment, then only the affected records are re-listed; the
+     * result is written to the index and handed to each manager.
+     */
+    class FolderWatcher : private juce::Thread
+    {
+    public:
+        FolderWatcher() : juce::Thread("Sample folder watcher") {}
+
+        ~FolderWatcher() override
+        {
+            stopThread(2000);
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        void add(SamplePresetManager& listener, const juce::File& samplesDir, const juce::File& indexFile,
+                 const std::vector<juce::String>& skip, const Library& current)
+        {
+            const juce::ScopedLock sl(lock);
+            if (fd < 0)
+                fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd < 0)
+                return;
+
+            auto root = findRoot(samplesDir);
+            if (root == nullptr)
+            {
+                root = std::make_shared<Root>();
+                root->samplesDir = samplesDir;
+                root->indexFile = indexFile;
+                root->skip = skip;
+                root->library = current;
+                roots.push_back(root);
+                syncWatches(*root);
+            }
+            else if (!sameLayout(root->library, current))
+            {
+                // The watcher's copy has seen every edit since it was created
+                listener.receiveLibrary(std::make_unique<Library>(root->library));
+            }
+
+            root->listeners.push_back(&listener);
+
+            if (!isThreadRunning())
+                startThread(juce::Thread::Priority::low);
+        }
+
+        // Once this returns the listener receives nothing more
+        void remove(SamplePresetManager& listener)
+        {
+            const juce::ScopedLock sl(lock);
+            for (size_t i = 0; i < roots.size(); ++i)
+            {
+                auto& listeners = roots[i]->listeners;
+                listeners.erase(std::remove(listeners.begin(), listeners.end(), &listener), listeners.end());
+
+                if (listeners.empty())
+                {
+                    for (const auto& [path, wd] : roots[i]->watched)
+                    {
+                        ::inotify_rm_watch(fd, wd);
+                        targets.erase(wd);
+                    }
+                    roots.erase(roots.begin() + static_cast<std::ptrdiff_t>(i--));
+                }
+            }
+        }
+
+    private:
+        static constexpr juce::uint32 WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+        static constexpr int IDLE_POLL_MS = 500;        // Also bounds how long stopThread waits
+        static constexpr int SETTLE_MS = 300;           // Quiet time before a burst of edits is applied
+        static constexpr juce::uint32 MAX_SETTLE_MS = 3000;
+
+        struct Changes
+        {
+            bool overflow = false;      // Events were dropped: fall back to the mtime rescan
+            bool relistRoot = false;    // Category folders added, removed or renamed
+            std::set<juce::String> categories;                           // Subfolders or loose files changed
+            std::set<std::pair<juce::String, juce::String>> folders;     // (category, folder) files changed
+
+            bool isEmpty() const { return !overflow && !relistRoot && categories.empty() && folders.empty(); }
+        };
+
+        struct Root
+        {
+            juce::File samplesDir;
+            juce::File indexFile;
+            std::vector<juce::String> skip;
+            Library library;                                // Written only by the watcher thread, under lock
+            std::vector<SamplePresetManager*> listeners;
+            std::map<juce::String, int> watched;            // Path -> watch descriptor
+            Changes changes;
+        };
+
+        // What a watch descriptor points at; empty category = the Samples folder itself
+        struct Target
+        {
+            Root* root = nullptr;
+            juce::String category;
+            juce::String folder;
+            juce::String path;
+        };
+
+        void run() override
+        {
+            bool pending = false;
+            juce::uint32 firstEventTime = 0;
+
+            while (!threadShouldExit())
+            {
+                pollfd pfd { fd, POLLIN, 0 };
+                const bool gotEvents = ::poll(&pfd, 1, pending ? SETTLE_MS : IDLE_POLL_MS) > 0;
+
+                if (gotEvents)
+                {
+                    readEvents();
+                    if (!pending)
+                        firstEventTime = juce::Time::getMillisecondCounter();
+                    pending = true;
+                }
+
+                // Apply once things go quiet, or periodically during a long copy
+                if (pending && (!gotEvents || juce::Time::getMillisecondCounter() - firstEventTime > MAX_SETTLE_MS))
+                {
+                    pending = applyChanges();
+                    firstEventTime = juce::Time::getMillisecondCounter();
+                }
+            }
+        }
+
+        void readEvents()
+        {
+            alignas(inotify_event) char buffer[16384];
+            const juce::ScopedLock sl(lock);
+
+            for (;;)
+            {
+                const auto bytes = ::read(fd, buffer, sizeof(buffer));
+                if (bytes <= 0)
+                    break;
+
+                for (ssize_t offset = 0; offset < bytes;)
+                {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    handleEvent(*event);
+                }
+            }
+        }
+
+        void handleEvent(const inotify_event& event)
+        {
+            if ((event.mask & IN_Q_OVERFLOW) != 0)
+            {
+                for (auto& root : roots)
+                    root->changes.overflow = true;
+                return;
+            }
+
+            auto it = targets.find(event.wd);
+            if (it == targets.end())
+                return;
+
+            if ((event.mask & IN_IGNORED) != 0)
+            {
+                // The folder is gone; its parent reports the removal
+                it->second.root->watched.erase(it->second.path);
+                targets.erase(it);
+                return;
+            }
+
+            const auto& target = it->second;
+            auto& changes = target.root->changes;
+            const bool isDirectory = (event.mask & IN_ISDIR) != 0;
+
+            if (target.category.isEmpty())
+            {
+                if (isDirectory)
+                    changes.relistRoot = true;      // Files at the top level (banks) are picked up on restart
+            }
+            else if (target.folder.isEmpty())
+            {
+                changes.categories.insert(target.category);
+            }
+            else if (!isDirectory)
+            {
+                changes.folders.insert({ target.category, target.folder });
+            }
+        }
+
+        // Returns true if another pass is needed
+        bool applyChanges()
+        {
+            std::vector<std::pair<std::shared_ptr<Root>, Changes>> work;
+            {
+                const juce::ScopedLock sl(lock);
+                for (auto& root : roots)
+                {
+                    if (!root->changes.isEmpty())
+                        work.push_back({ root, std::exchange(root->changes, Changes()) });
+                }
+            }
+
+            bool again = false;
+            for (auto& [root, changes] : work)
+            {
+                // Only this thread writes root->library, so it can be read unlocked
+                auto next = update(*root, changes);
+                if (threadShouldExit())
+                    return false;
+
+                const juce::ScopedLock sl(lock);
+                if (std::find(roots.begin(), roots.end(), root) == roots.end())
+                    continue;   // Every listener went away meanwhile
+
+                root->library = std::move(next);
+
+                // Files copied into a new folder before its watch existed would be
+                // missed, so each newly watched folder is listed once more
+                for (auto& added : syncWatches(*root))
+                    root->changes.folders.insert(std::move(added));
+                again = again || !root->changes.isEmpty();
+
+                writeIndex(root->indexFile, root->samplesDir, root->library);
+                for (auto* listener : root->listeners)
+                    listener->receiveLibrary(std::make_unique<Library>(root->library));
+            }
+            return again;
+        }
+
+        Library update(const Root& root, const Changes& changes)
+        {
+            if (changes.overflow)
+                return scanLibrary(root.samplesDir, &root.library, root.skip, this);
+
+            Library next;
+            if (changes.relistRoot)
+            {
+                for (const auto& categoryDir : root.samplesDir.findChildFiles(juce::File::findDirectories, false))
+                {
+                    const auto name = categoryDir.getFileName();
+                    if (std::find(root.skip.begin(), root.skip.end(), name) != root.skip.end())
+                        continue;
+
+                    if (const auto* old = findCategory(&root.library, name))
+                        next.push_back(*old);
+                    else
+                        next.push_back(scanCategory(categoryDir, nullptr, true));
+                }
+            }
+            else
+            {
+                next = root.library;
+            }
+
+            for (auto& category : next)
+            {
+                const auto categoryDir = root.samplesDir.getChildFile(category.name);
+                if (changes.categories.count(category.name) > 0)
+                    category = scanCategory(categoryDir, &category, true);
+
+                for (auto& folder : category.folders)
+                {
+                    if (changes.folders.count({ category.name, folder.name }) > 0)
+                        folder = scanFolderRecord(categoryDir.getChildFile(folder.name), category.name, nullptr);
+                }
+            }
+            return next;
+        }
+
+        // Watches every folder in the root's library; returns preset folders that were not watched before
+        std::vector<std::pair<juce::String, juce::String>> syncWatches(Root& root)
+        {
+            std::vector<std::pair<juce::String, juce::String>> added;
+
+            watch(root, root.samplesDir, {}, {});
+            for (const auto& category : root.library)
+            {
+                const auto categoryDir = root.samplesDir.getChildFile(category.name);
+                watch(root, categoryDir, category.name, {});
+
+                for (const auto& folder : category.folders)
+                {
+                    if (watch(root, categoryDir.getChildFile(folder.name), category.name, folder.name))
+                        added.push_back({ category.name, folder.name });
+                }
+            }
+            return added;
+        }
+
+        bool watch(Root& root, const juce::File& dir, const juce::String& category, const juce::String& folder)
+        {
+            const auto path = dir.getFullPathName();
+            if (root.watched.count(path) > 0)
+                return false;
+
+            // Fails once fs.inotify.max_user_watches is reached; such folders
+            // are still caught by the mtime check at the next startup
+            const int wd = ::inotify_add_watch(fd, path.toRawUTF8(), WATCH_MASK);
+            if (wd < 0)
+                return false;
+
+            auto existing = targets.find(wd);
+            if (existing != targets.end())
+                existing->second.root->watched.erase(existing->second.path);   // Same folder, renamed
+
+            targets[wd] = { &root, category, folder, path };
+            root.watched[path] = wd;
+            return true;
+        }
+
+        std::shared_ptr<Root> findRoot(const juce::File& samplesDir) const
+        {
+            for (const auto& root : roots)
+                if (root->samplesDir == samplesDir)
+                    return root;
+            return nullptr;
+        }
+
+        juce::CriticalSection lock;
+        int fd = -1;
+        std::vector<std::shared_ptr<Root>> roots;
+        std::map<int, Target> targets;
+    };
+   #endif
+
+    // Any thread: queue a new library for the message thread
+    void receiveLibrary(std::unique_ptr<Library> updated)
+    {
+        {
+            const juce::ScopedLock sl(pendingLock);
+            pendingLibrary = std::move(updated);
+        }
+        triggerAsyncUpdate();
+    }
+
+    void startWatching(const Library& current)
+    {
+       #if JUCE_LINUX
+        folderWatcher->add(*this, samplesDir, indexFile, bankCategories, current);
+       #else
+        juce::ignoreUnused(current);
+       #endif
+    }
+
+    void stopWatching()
+    {
+       #if JUCE_LINUX
+        folderWatcher->remove(*this);
+       #endif
+    }
+
+    void handleAsyncUpdate() override
+    {
+        std::unique_ptr<Library> updated;
+        {
+            const juce::ScopedLock sl(pendingLock);
+            updated = std::move(pendingLibrary);
+        }
+
+        if (updated != nullptr)
+        {
+            library = std::move(*updated);
+            rebuild();
+        }
+
+        if (rescanFinished.exchange(false, std::memory_order_acq_rel) && onRescanFinished)
+            onRescanFinished();
+    }
+
+    // Flattens banks and the library into the preset list and its lookups
+    void rebuild()
+    {
+        presets = bankPresets;
+        categories = bankCategories;
+
+        for (const auto& category : library)
+        {
+            if (std::find(categories.begin(), categories.end(), category.name) != categories.end())
+                continue;   // Already provided by a packed bank
+
+            categories.push_back(category.name);
+            for (const auto& folder : category.folders)
+                presets.insert(presets.end(), folder.presets.begin(), folder.presets.end());
+            presets.insert(presets.end(), category.loosePresets.begin(), category.loosePresets.end());
+        }
+
+        presetsByName.clear();
+        presetsById.clear();
+        presetsByName.reserve(presets.size());
+        presetsById.reserve(presets.size());
+
+        for (size_t i = 0; i < presets.size(); ++i)
+        {
+            auto& preset = presets[i];
+            preset.id = makePresetId(preset.category, preset.name);
+            presetsByName.emplace(preset.name, i);
+            presetsById.emplace(preset.id, i);
+        }
+
+        libraryVersion.fetch_add(1, std::memory_order_release);
+    }
+
+    // Banks are memory-mapped, so reopening them is cheap and they are never indexed
+    void openBanks(bool usePackedBanks)
+    {
+        bankPresets.clear();
+        bankCategories.clear();
+
+        if (!usePackedBanks || !samplesDir.isDirectory())
+            return;
+
+        for (const auto& bankFile : samplesDir.findChildFiles(juce::File::findFiles, false,
+                                                              juce::String("*") + SampleBankFormat::FILE_EXTENSION))
+            addBank(bankFile);
+    }
+
+    /**
+     * Lists the category folders, reusing records from `previous` whose
+     * modification time is unchanged. Categories in `skip` are left out.
+     * Stops early (with a partial result) once `thread` is asked to exit.
+     */
+    static Library scanLibrary(const juce::File& samplesDir, const Library* previous,
+                               const std::vector<juce::String>& skip, juce::Thread* thread)
+    {
+        Library result;
+        if (!samplesDir.isDirectory())
+            return result;
+
+        for (const auto& categoryDir : samplesDir.findChildFiles(juce::File::findDirectories, false))
         {
-            if (preset.name == name)
-                return &preset;
+            if (thread != nullptr && thread->threadShouldExit())
+                break;
+
+            const auto name = categoryDir.getFileName();
+            if (std::find(skip.begin(), skip.end(), name) != skip.end())
+                continue;   // Provided by a packed bank
+
+            result.push_back(scanCategory(categoryDir, findCategory(previous, name), false));
+        }
+
+        return result;
+    }
+
+    static const CategoryRecord* findCategory(const Library* lib, const juce::String& name)
+    {
+        if (lib != nullptr)
+        {
+            for (const auto& c : *lib)
+                if (c.name == name)
+                    return &c;
         }
         return nullptr;
     }
 
-private:
+    // relist = true lists the folder even if its modification time is unchanged
+    static CategoryRecord scanCategory(const juce::File& categoryDir, const CategoryRecord* old, bool relist)
+    {
+        CategoryRecord record;
+        record.name = categoryDir.getFileName();
+        record.modified = categoryDir.getLastModificationTime().toMilliseconds();
+
+        if (!relist && old != nullptr && old->modified == record.modified)
+        {
+            // Same entries as before: only the preset folders need checking
+            for (const auto& f : old->folders)
+                record.folders.push_back(scanFolderRecord(categoryDir.getChildFile(f.name), record.name, old));
+            record.loosePresets = old->loosePresets;
+        }
+        else
+        {
+            for (const auto& presetDir : categoryDir.findChildFiles(juce::File::findDirectories, false))
+                record.folders.push_back(scanFolderRecord(presetDir, record.name, old));
+            scanLooseFiles(categoryDir, record.name, record.loosePresets);
+        }
+
+        return record;
+    }
+
+    // Reuses the folder's record from `old` if its modification time is unchanged
+    static FolderRecord scanFolderRecord(const juce::File& presetDir, const juce::String& category,
+                                         const CategoryRecord* old)
+    {
+        FolderRecord folder;
+        folder.name = presetDir.getFileName();
+        folder.modified = presetDir.getLastModificationTime().toMilliseconds();
+
+        if (old != nullptr)
+        {
+            for (const auto& f : old->folders)
+            {
+                if (f.name == folder.name && f.modified == folder.modified)
+                    return f;
+            }
+        }
+
+        scanPresetFolder(presetDir, category, folder.presets);
+        return folder;
+    }
+    static bool sameLayout(const Library& a, const Library& b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t c = 0; c < a.size(); ++c)
+        {
+            if (a[c].name != b[c].name || a[c].modified != b[c].modified
+                || a[c].folders.size() != b[c].folders.size())
+                return false;
+
+            for (size_t f = 0; f < a[c].folders.size(); ++f)
+            {
+                if (a[c].folders[f].name != b[c].folders[f].name
+                    || a[c].folders[f].modified != b[c].folders[f].modified)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Each subfolder of a category is one multisampled preset
+    static void scanPresetFolder(const juce::File& presetDir, const juce::String& category,
+                                 std::vector<SamplePreset>& out)
+    {
+        auto wavFiles = presetDir.findChildFiles(juce::File::findFiles, false, "*.wav");
+        if (wavFiles.isEmpty())
+            return;
+
+        SamplePreset preset;
+        preset.name = presetDir.getFileName();
+        preset.category = category;
+        preset.isMultisampled = true;
+
+        // Collect all samples with their MIDI notes
+        std::vector<std::pair<int, juce::File>> notesAndFiles;
+
+        juce::String presetFolderName = presetDir.getFileName();
+
+        // First pass: count unique base names to detect if folder has mixed presets
+        std::set<juce::String> uniqueBaseNames;
+        for (const auto& wav : wavFiles)
+        {
+            juce::String fileName = wav.getFileNameWithoutExtension();
+            int msIndex = fileName.indexOf("_ms0_");
+            juce::String baseName = (msIndex > 0) ? fileName.substring(0, msIndex) : fileName;
+            uniqueBaseNames.insert(baseName.toLowerCase());
+        }
+
+        // If all files share the same base name, include them all
+        // (handles cases like "First Choice" folder with "Init Patch" samples)
+        bool allSameBaseName = (uniqueBaseNames.size() == 1);
+
+        for (const auto& wav : wavFiles)
+        {
+            juce::String fileName = wav.getFileNameWithoutExtension();
+
+            // If all files have the same base name, include them all
+            // Otherwise, filter to only include files matching the folder name
+            bool belongsToPreset = allSameBaseName;
+
+            if (!allSameBaseName)
+            {
+                // Extract the base name from the wav file (before _ms0_XXX_)
+                int msIndex = fileName.indexOf("_ms0_");
+                juce::String baseName = (msIndex > 0) ? fileName.substring(0, msIndex) : fileName;
+
+                // Remove common prefixes like "A001 ", "F018 " etc
+                if (baseName.length() > 5 && baseName[4] == ' ')
+                {
+                    bool hasPrefix = true;
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        char ch = baseName[c];
+                        if (!((ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')))
+                            hasPrefix = false;
+                    }
+                    if (hasPrefix)
+                        baseName = baseName.substring(5);
+                }
+
+                // Check if folder name matches the cleaned base name
+                if (presetFolderName.equalsIgnoreCase(baseName) ||
+                    presetFolderName.containsIgnoreCase(baseName) ||
+                    baseName.containsIgnoreCase(presetFolderName))
+                {
+                    belongsToPreset = true;
+                }
+
+                // Skip generic "Init Patch" samples when mixed with other samples
+                if (fileName.startsWithIgnoreCase("Init Patch"))
+                    belongsToPreset = false;
+            }
+
+            if (!belongsToPreset)
+                continue;
+
+            // Parse note from filename like "ShapeURMusic_ms0_060_c3.wav"
+            // or "Init Patch_ms0_060_c3.wav"
+            juce::String name = fileName;
+
+            // Look for _XXX_ pattern where XXX is MIDI note number
+            int lastUnderscore = name.lastIndexOf("_");
+            if (lastUnderscore > 0)
+            {
+                // Find second-to-last underscore by searching in substring
+                juce::String beforeLast = name.substring(0, lastUnderscore);
+                int secondLastUnderscore = beforeLast.lastIndexOf("_");
+                if (secondLastUnderscore >= 0)
+                {
+                    juce::String noteStr = name.substring(secondLastUnderscore + 1, lastUnderscore);
+                    int midiNote = noteStr.getIntValue();
+                    if (midiNote >= 21 && midiNote <= 108)
+                    {
+                        notesAndFiles.push_back({midiNote, wav});
+                    }
+                }
+            }
+        }
+
+        // Sort by MIDI note
+        std::sort(notesAndFiles.begin(), notesAndFiles.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // Calculate key ranges for each sample
+        // Each sample covers from halfway to previous sample to halfway to next sample
+        for (size_t i = 0; i < notesAndFiles.size(); ++i)
+        {
+            SampleZoneInfo zone;
+            zone.sampleFile = notesAndFiles[i].second;
+            zone.rootNote = notesAndFiles[i].first;
+
+            // Calculate low key (halfway between this and previous sample)
+            if (i == 0)
+                zone.lowKey = 0;  // First sample covers from bottom
+            else
+                zone.lowKey = (notesAndFiles[i-1].first + notesAndFiles[i].first) / 2 + 1;
+
+            // Calculate high key (halfway between this and next sample)
+            if (i == notesAndFiles.size() - 1)
+                zone.highKey = 127;  // Last sample covers to top
+            else
+                zone.highKey = (notesAndFiles[i].first + notesAndFiles[i+1].first) / 2;
+
+            preset.zones.push_back(zone);
+        }
+
+        // Also set the main sampleFile to C4 or closest for backwards compat
+        if (!notesAndFiles.empty())
+        {
+            int bestIdx = 0;
+            int bestDist = std::abs(notesAndFiles[0].first - 60);
+            for (size_t i = 1; i < notesAndFiles.size(); ++i)
+            {
+                int dist = std::abs(notesAndFiles[i].first - 60);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    bestIdx = static_cast<int>(i);
+                }
+            }
+            preset.sampleFile = notesAndFiles[bestIdx].second;
+            preset.rootNote = notesAndFiles[bestIdx].first;
+        }
+
+        out.push_back(preset);
+    }
+
+    // Loose files directly in the category folder are single-sample presets (e.g. Moog Bass)
+    static void scanLooseFiles(const juce::File& categoryDir, const juce::String& category,
+                               std::vector<SamplePreset>& out)
+    {
+        for (const auto& sampleFile : categoryDir.findChildFiles(juce::File::findFiles, false, "*.wav;*.mp3;*.aif;*.aiff"))
+        {
+            SamplePreset preset;
+            preset.name = sampleFile.getFileNameWithoutExtension();
+            preset.category = category;
+            preset.sampleFile = sampleFile;
+
+            // Set default root note based on category
+            if (category == "Bass" || category == "Synth Bass" || category == "Moog Bass" || category.containsIgnoreCase("Bass"))
+                preset.rootNote = 36;  // C2 for bass sounds
+            else
+                preset.rootNote = 60;  // C4 for everything else
+
+            out.push_back(preset);
+        }
+    }
+
+    //==========================================================================
+    // Index file: header, then categories -> folders -> presets -> zones.
+    // Sample files are stored by name only; they live in their folder.
+
+    static void writePreset(juce::OutputStream& out, const SamplePreset& preset)
+    {
+        out.writeString(preset.name);
+        out.writeString(preset.sampleFile.getFileName());
+        out.writeInt(preset.rootNote);
+        out.writeBool(preset.loopEnabled);
+        out.writeBool(preset.isMultisampled);
+
+        out.writeInt(static_cast<int>(preset.zones.size()));
+        for (const auto& zone : preset.zones)
+        {
+            out.writeString(zone.sampleFile.getFileName());
+            out.writeInt(zone.rootNote);
+            out.writeInt(zone.lowKey);
+            out.writeInt(zone.highKey);
+        }
+    }
+
+    static bool readPresets(juce::InputStream& in, const juce::File& dir, const juce::String& category,
+                            std::vector<SamplePreset>& out)
+    {
+        const int numPresets = in.readInt();
+        if (numPresets < 0 || numPresets > MAX_INDEX_COUNT)
+            return false;
+
+        for (int p = 0; p < numPresets; ++p)
+        {
+            SamplePreset preset;
+            preset.name = in.readString();
+            preset.category = category;
+            preset.sampleFile = dir.getChildFile(in.readString());
+            preset.rootNote = in.readInt();
+            preset.loopEnabled = in.readBool();
+            preset.isMultisampled = in.readBool();
+
+            const int numZones = in.readInt();
+            if (numZones < 0 || numZones > MAX_INDEX_COUNT)
+                return false;
+
+            for (int z = 0; z < numZones; ++z)
+            {
+                SampleZoneInfo zone;
+                zone.sampleFile = dir.getChildFile(in.readString());
+                zone.rootNote = in.readInt();
+                zone.lowKey = in.readInt();
+                zone.highKey = in.readInt();
+                preset.zones.push_back(zone);
+            }
+
+            out.push_back(std::move(preset));
+        }
+        return true;
+    }
+
+    static void writeIndex(const juce::File& file, const juce::File& samplesDir, const Library& lib)
+    {
+        if (file == juce::File())
+            return;
+
+        file.getParentDirectory().createDirectory();
+
+        // Written aside and moved into place, so readers never see half an index
+        juce::TemporaryFile temp(file);
+        {
+            juce::FileOutputStream out(temp.getFile());
+            if (!out.openedOk())
+                return;
+
+            out.writeInt(INDEX_MAGIC);
+            out.writeInt(INDEX_VERSION);
+            out.writeString(samplesDir.getFullPathName());
+
+            out.writeInt(static_cast<int>(lib.size()));
+            for (const auto& category : lib)
+            {
+                out.writeString(category.name);
+                out.writeInt64(category.modified);
+
+                out.writeInt(static_cast<int>(category.folders.size()));
+                for (const auto& folder : category.folders)
+                {
+                    out.writeString(folder.name);
+                    out.writeInt64(folder.modified);
+                    out.writeInt(static_cast<int>(folder.presets.size()));
+                    for (const auto& preset : folder.presets)
+                        writePreset(out, preset);
+                }
+
+                out.writeInt(static_cast<int>(category.loosePresets.size()));
+                for (const auto& preset : category.loosePresets)
+                    writePreset(out, preset);
+            }
+
+            out.writeInt(INDEX_MAGIC);    // Trailer: catches truncated files
+            out.flush();
+            if (out.getStatus().failed())
+                return;
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    // Empty if the file is missing, damaged, from another version or for another Samples folder
+    static std::optional<Library> readIndex(const juce::File& file, const juce::File& samplesDir)
+    {
+        if (!file.existsAsFile())
+            return std::nullopt;
+
+        juce::FileInputStream in(file);
+        if (!in.openedOk() || in.readInt() != INDEX_MAGIC || in.readInt() != INDEX_VERSION
+            || in.readString() != samplesDir.getFullPathName())
+            return std::nullopt;
+
+        const int numCategories = in.readInt();
+        if (numCategories < 0 || numCategories > MAX_INDEX_COUNT)
+            return std::nullopt;
+
+        Library lib;
+        lib.reserve(static_cast<size_t>(numCategories));
+        for (int c = 0; c < numCategories; ++c)
+        {
+            CategoryRecord category;
+            category.name = in.readString();
+            category.modified = in.readInt64();
+            const auto categoryDir = samplesDir.getChildFile(category.name);
+
+            const int numFolders = in.readInt();
+            if (numFolders < 0 || numFolders > MAX_INDEX_COUNT)
+                return std::nullopt;
+
+            for (int f = 0; f < numFolders; ++f)
+            {
+                FolderRecord folder;
+                folder.name = in.readString();
+                folder.modified = in.readInt64();
+                if (!readPresets(in, categoryDir.getChildFile(folder.name), category.name, folder.presets))
+                    return std::nullopt;
+                category.folders.push_back(std::move(folder));
+            }
+
+            if (!readPresets(in, categoryDir, category.name, category.loosePresets))
+                return std::nullopt;
+
+            lib.push_back(std::move(category));
+        }
+
+        if (in.readInt() != INDEX_MAGIC || !in.isExhausted())
+            return std::nullopt;
+
+        return lib;
+    }
+
+    void addBank(const juce::File& bankFile)
+    {
+        auto bank = SampleBank::open(bankFile);
+        if (bank == nullptr)
+            return;
+
+        const auto category = bank->getCategory();
+        bankCategories.push_back(category);
+
+        for (int i = 0; i < bank->getNumPresets(); ++i)
+        {
+            const auto& entry = bank->getPreset(i);
+
+            SamplePreset preset;
+            preset.name = bank->getPresetName(i);
+            preset.category = category;
+            preset.sampleFile = bankFile;
+            preset.rootNote = entry.rootNote;
+            preset.isMultisampled = (entry.flags & SampleBankFormat::FLAG_MULTISAMPLED) != 0;
+            preset.bank = bank;
+            preset.bankPresetIndex = i;
+
+            for (uint32_t z = 0; z < entry.numZones; ++z)
+            {
+                const auto& zone = bank->getZone(static_cast<int>(entry.firstZone + z));
+                SampleZoneInfo info;
+                info.sampleFile = bankFile;
+                info.rootNote = zone.rootNote;
+                info.lowKey = zone.lowKey;
+                info.highKey = zone.highKey;
+                preset.zones.push_back(info);
+            }
+
+            bankPresets.push_back(preset);
+        }
+    }
+
+    juce::File samplesDir;
+    juce::File indexFile;
+    Library library;
+    std::vector<SamplePreset> bankPresets;
+    std::vector<juce::String> bankCategories;
+
+    // Flattened view, rebuilt whenever the library or banks change
     std::vector<SamplePreset> presets;
     std::vector<juce::String> categories;
+    std::unordered_map<juce::String, size_t> presetsByName;
+    std::unordered_map<juce::int64, size_t> presetsById;
+    std::atomic<juce::uint32> libraryVersion { 0 };
+
+    juce::CriticalSection pendingLock;
+    std::unique_ptr<Library> pendingLibrary;
+    std::atomic<bool> rescanFinished { false };
+    Rescanner rescanner { *this };
+
+   #if JUCE_LINUX
+    juce::SharedResourcePointer<FolderWatcher> folderWatcher;
+   #endif
 };
 
 } // namespace Engine
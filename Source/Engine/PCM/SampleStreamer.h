@@ -0,0 +1,390 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "CompactSampleBuffer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace NulyBeats {
+namespace Engine {
+
+/**
+ * A sample played from disk
+ * The first frames (the "head") stay resident so a note can start instantly.
+ * The rest is streamed by SampleStreamer while the note plays. The head
+ * may be kept at the source's integer width.
+ * Immutable once constructed, so the audio thread and the I/O thread can
+ * read it without locking.
+ */
+class StreamedSample
+{
+public:
+    StreamedSample(const juce::File& sourceFile, juce::AudioFormatReader& reader, int preloadFrames,
+                   CompactSampleBuffer::Encoding encoding = CompactSampleBuffer::Encoding::Float32)
+        : file(sourceFile),
+          length(reader.lengthInSamples),
+          sampleRate(reader.sampleRate),
+          numChannels(juce::jlimit(1, 2, static_cast<int>(reader.numChannels))),
+          id(nextId().fetch_add(1, std::memory_order_relaxed))
+    {
+        headFrames = static_cast<int>(std::min<juce::int64>(preloadFrames, length));
+        head = CompactSampleBuffer(reader, numChannels, headFrames, juce::jmax(1, headFrames), encoding);
+    }
+
+    const juce::File& getFile() const { return file; }
+    juce::int64 getLength() const { return length; }
+    double getSampleRate() const { return sampleRate; }
+    int getNumChannels() const { return numChannels; }
+    int getHeadFrames() const { return headFrames; }
+    const CompactSampleBuffer& getHead() const { return head; }
+    juce::uint64 getId() const { return id; }
+
+    size_t getResidentBytes() const { return head.getBytes(); }
+
+private:
+    static std::atomic<juce::uint64>& nextId()
+    {
+        static std::atomic<juce::uint64> counter { 1 };
+        return counter;
+    }
+
+    juce::File file;
+    juce::int64 length = 0;
+    double sampleRate = 44100.0;
+    int numChannels = 1;
+    int headFrames = 0;
+    CompactSampleBuffer head;
+    juce::uint64 id = 0;    // Never reused, unlike addresses
+};
+
+/**
+ * Disk streaming engine for sample playback
+ *
+ * Each voice owns one Stream: a ring per channel that the I/O thread fills
+ * with the frames after the sample's resident head, ahead of the play head.
+ * Frame f of the sample lives at ring slot f & (ring size - 1). The rings
+ * hold one host block plus one I/O pass at up to MAX_PITCH_RATIO, and a
+ * couple of chunks of slack, so they stay small; notes pitched further up
+ * may underrun.
+ *
+ * Handoff is lock-free single-producer / single-consumer:
+ * - The voice (audio thread) starts and stops a stream by swapping the
+ *   sample pointer and bumping a generation counter.
+ * - The voice publishes its play position every block. The I/O thread never
+ *   writes more than a ring ahead of it.
+ * - The I/O thread publishes the filled frame count tagged with the
+ *   generation it filled for. Stale data from a previous note is ignored.
+ *
+ * If the play head catches up with the filled region, the voice outputs
+ * silence and the stream's underrun counter is bumped (once per block).
+ *
+ * Readers are opened lazily on the I/O thread and a bounded number stay
+ * open, so libraries with thousands of zones do not exhaust file handles.
+ */
+class SampleStreamer
+{
+public:
+    static constexpr int CHUNK_FRAMES = 2048;               // Largest single disk read
+    static constexpr int MAX_PITCH_RATIO = 4;               // Source frames per output frame the rings are sized for
+    static constexpr int MAX_OPEN_READERS = 64;
+    static constexpr float DEFAULT_PRELOAD_MS = 250.0f;
+
+    class Stream
+    {
+    public:
+        // Audio thread: begin streaming a sample from just after its head. The
+        // I/O thread picks it up on its next pass; the head covers the wait.
+        void start(const StreamedSample* newSample)
+        {
+            consumed.store(0, std::memory_order_relaxed);
+            sample.store(newSample, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+        }
+
+        // Audio thread: stop streaming (the I/O thread forgets the sample on its next pass)
+        void stop()
+        {
+            if (sample.load(std::memory_order_relaxed) == nullptr)
+                return;
+
+            sample.store(nullptr, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+        }
+
+        // Audio thread: the lowest frame the voice still needs
+        void setPlayPosition(juce::int64 frame)
+        {
+            consumed.store(frame, std::memory_order_release);
+        }
+
+        // Audio thread: frames [0, n) of the current sample can be read now
+        juce::int64 getReadableFrames() const
+        {
+            const auto* s = sample.load(std::memory_order_relaxed);
+            if (s == nullptr)
+                return 0;
+
+            const juce::uint64 packed = filled.load(std::memory_order_acquire);
+            const juce::uint64 gen = generation.load(std::memory_order_relaxed);
+            if ((packed >> FRAME_BITS) != (gen & GENERATION_MASK))
+                return s->getHeadFrames();
+
+            return static_cast<juce::int64>(packed & FRAME_MASK);
+        }
+
+        // Audio thread: one frame of one channel; only valid below getReadableFrames()
+        float read(const StreamedSample& s, int channel, juce::int64 frame) const
+        {
+            const int c = std::min(channel, s.getNumChannels() - 1);
+            if (frame < s.getHeadFrames())
+                return s.getHead().getSample(c, frame);
+
+            return ring[static_cast<size_t>(c)][static_cast<size_t>(frame) & ringMask];
+        }
+
+        void reportUnderrun() { underruns.fetch_add(1, std::memory_order_relaxed); }
+        uint32_t getUnderrunCount() const { return underruns.load(std::memory_order_relaxed); }
+        bool isActive() const { return sample.load(std::memory_order_relaxed) != nullptr; }
+
+    private:
+        friend class SampleStreamer;
+
+        static constexpr int FRAME_BITS = 40;
+        static constexpr juce::uint64 FRAME_MASK = (juce::uint64(1) << FRAME_BITS) - 1;
+        static constexpr juce::uint64 GENERATION_MASK = (juce::uint64(1) << (64 - FRAME_BITS)) - 1;
+
+        // I/O thread
+        void publish(juce::uint32 gen, juce::int64 frames)
+        {
+            filled.store(((static_cast<juce::uint64>(gen) & GENERATION_MASK) << FRAME_BITS)
+                             | (static_cast<juce::uint64>(frames) & FRAME_MASK),
+                         std::memory_order_release);
+        }
+
+        std::array<std::vector<float>, 2> ring;
+        size_t ringMask = 0;
+
+        std::atomic<const StreamedSample*> sample { nullptr };
+        std::atomic<juce::uint32> generation { 0 };
+        std::atomic<juce::uint64> filled { 0 };
+        std::atomic<juce::int64> consumed { 0 };
+        std::atomic<uint32_t> underruns { 0 };
+
+        // I/O thread only
+        juce::uint32 ioGeneration = 0;
+        juce::int64 ioFilled = 0;
+    };
+
+    explicit SampleStreamer(int numStreams)
+        : worker(*this)
+    {
+        formatManager.registerBasicFormats();
+        for (int i = 0; i < numStreams; ++i)
+            streams.push_back(std::make_unique<Stream>());
+        scratch.setSize(2, CHUNK_FRAMES);
+    }
+
+    ~SampleStreamer()
+    {
+        worker.stopThread(2000);
+    }
+
+    /**
+     * Size the rings for the host's block size and start the I/O thread (not
+     * on the audio thread). Streams are stopped if the ring size changes.
+     */
+    void prepare(double sampleRate, int maxBlockSize)
+    {
+        const int ioPassFrames = static_cast<int>(std::ceil(IO_INTERVAL_MS * 0.001 * sampleRate));
+        const int ringFrames = juce::nextPowerOfTwo((juce::jmax(1, maxBlockSize) + ioPassFrames) * MAX_PITCH_RATIO
+                                                    + 2 * CHUNK_FRAMES);
+
+        {
+            const juce::ScopedLock sl(ioLock);
+            for (auto& stream : streams)
+            {
+                if (stream->ring[0].size() == static_cast<size_t>(ringFrames))
+                    continue;
+
+                stream->stop();
+                for (auto& channel : stream->ring)
+                    channel.assign(static_cast<size_t>(ringFrames), 0.0f);
+                stream->ringMask = static_cast<size_t>(ringFrames - 1);
+            }
+        }
+
+        if (!worker.isThreadRunning())
+            worker.startThread(juce::Thread::Priority::high);
+    }
+
+    Stream* getStream(int index) { return streams[static_cast<size_t>(index)].get(); }
+
+    /**
+     * Stop every stream and wait for the I/O thread to finish its current pass.
+     * Call before destroying StreamedSamples, once no voice can start them again.
+     */
+    void stopAll()
+    {
+        for (auto& stream : streams)
+            stream->stop();
+
+        const juce::ScopedLock sl(ioLock);
+        openReaders.clear();
+    }
+
+    /**
+     * Wait for the I/O thread to finish its current pass. Afterwards it no
+     * longer touches the samples of streams stopped before the call.
+     */
+    void synchronise()
+    {
+        const juce::ScopedLock sl(ioLock);
+    }
+
+    uint32_t getUnderrunCount() const
+    {
+        uint32_t total = 0;
+        for (const auto& stream : streams)
+            total += stream->getUnderrunCount();
+        return total;
+    }
+
+    int getActiveStreamCount() const
+    {
+        int n = 0;
+        for (const auto& stream : streams)
+            n += stream->isActive() ? 1 : 0;
+        return n;
+    }
+
+    static int preloadFramesFor(double sampleRate, float preloadMs)
+    {
+        return juce::jmax(CHUNK_FRAMES, static_cast<int>(std::ceil(preloadMs * 0.001 * sampleRate)));
+    }
+
+private:
+    static constexpr int IO_INTERVAL_MS = 5;
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(SampleStreamer& o) : juce::Thread("Sample streaming"), owner(o) {}
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                wait(IO_INTERVAL_MS);
+
+                // Keep going while any stream still had room; one chunk per stream per pass
+                const juce::ScopedLock sl(owner.ioLock);
+                while (owner.servicePass() && !threadShouldExit()) {}
+            }
+        }
+
+    private:
+        SampleStreamer& owner;
+    };
+
+    struct OpenReader
+    {
+        juce::uint64 sampleId = 0;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+    };
+
+    // One refill round over all streams; true if any stream read data
+    bool servicePass()
+    {
+        bool didWork = false;
+        for (auto& stream : streams)
+            didWork |= service(*stream);
+        return didWork;
+    }
+
+    bool service(Stream& s)
+    {
+        const juce::uint32 gen = s.generation.load(std::memory_order_acquire);
+        const auto* sample = s.sample.load(std::memory_order_relaxed);
+        if (sample == nullptr || s.ring[0].empty())
+            return false;
+
+        if (gen != s.ioGeneration)
+        {
+            s.ioGeneration = gen;
+            s.ioFilled = sample->getHeadFrames();
+            s.publish(gen, s.ioFilled);
+        }
+
+        const auto ringFrames = static_cast<juce::int64>(s.ring[0].size());
+        const juce::int64 limit = std::min(sample->getLength(),
+                                           s.consumed.load(std::memory_order_acquire) + ringFrames);
+        const int n = static_cast<int>(std::min<juce::int64>(CHUNK_FRAMES, limit - s.ioFilled));
+        if (n <= 0)
+            return false;
+
+        auto* reader = getReader(*sample);
+        if (reader == nullptr)
+            return false;
+
+        reader->read(&scratch, 0, n, s.ioFilled, true, sample->getNumChannels() > 1);
+
+        for (int c = 0; c < sample->getNumChannels(); ++c)
+        {
+            const float* src = scratch.getReadPointer(c);
+            auto& dst = s.ring[static_cast<size_t>(c)];
+            const int first = static_cast<int>(static_cast<size_t>(s.ioFilled) & s.ringMask);
+            const int split = std::min(n, static_cast<int>(ringFrames) - first);
+            std::copy(src, src + split, dst.begin() + first);
+            std::copy(src + split, src + n, dst.begin());
+        }
+
+        s.ioFilled += n;
+
+        // If the voice moved on meanwhile, the new generation simply won't match
+        s.publish(gen, s.ioFilled);
+        return true;
+    }
+
+    juce::AudioFormatReader* getReader(const StreamedSample& sample)
+    {
+        for (auto& open : openReaders)
+            if (open.sampleId == sample.getId())
+                return open.reader.get();
+
+        if (static_cast<int>(openReaders.size()) >= MAX_OPEN_READERS)
+        {
+            // Close one that no stream is playing
+            auto unused = std::find_if(openReaders.begin(), openReaders.end(), [this](const OpenReader& r) {
+                return std::none_of(streams.begin(), streams.end(), [&](const auto& st) {
+                    const auto* playing = st->sample.load(std::memory_order_relaxed);
+                    return playing != nullptr && playing->getId() == r.sampleId;
+                });
+            });
+            if (unused != openReaders.end())
+                openReaders.erase(unused);
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sample.getFile()));
+        if (reader == nullptr)
+            return nullptr;
+
+        openReaders.push_back({ sample.getId(), std::move(reader) });
+        return openReaders.back().reader.get();
+    }
+
+    std::vector<std::unique_ptr<Stream>> streams;
+
+    // I/O thread state, guarded by ioLock
+    juce::CriticalSection ioLock;
+    juce::AudioFormatManager formatManager;
+    juce::AudioBuffer<float> scratch;
+    std::vector<OpenReader> openReaders;
+
+    Worker worker;
+};
+
+} // namespace Engine
+} // namespace NulyBeats
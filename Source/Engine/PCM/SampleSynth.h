@@ -2,6 +2,10 @@
 
 #include <JuceHeader.h>
 #include "../../DSP/Modulators/ADSR.h"
+#include "SampleStreamer.h"
+#include "SampleBank.h"
+#include "SamplePool.h"
+#include "LazyZoneMap.h"
 
 namespace NulyBeats {
 namespace Engine {
@@ -23,35 +27,76 @@ struct SampleEnvelopeParams
 
 /**
  * Extended SamplerSound that stores original BPM for tempo sync
+ * The audio comes from the shared SamplePool (whose full copy may be evicted
+ * and reloaded at any time - getAudioData() only returns the always-resident
+ * head), is mapped from a packed bank, or belongs to a LazyZoneMap and
+ * arrives when it is first played.
  */
 class TempoSyncSamplerSound : public juce::SynthesiserSound
 {
 public:
     TempoSyncSamplerSound(const juce::String& soundName,
-                          juce::AudioFormatReader& source,
+                          std::shared_ptr<PooledSample> sample,
                           const juce::BigInteger& midiNotes,
                           int midiNoteForNormalPitch,
                           double attackTimeSecs,
                           double releaseTimeSecs,
-                          double maxSampleLengthSeconds,
                           double originalBPM)
         : name(soundName),
-          sourceSampleRate(source.sampleRate),
           midiNotes(midiNotes),
           midiRootNote(midiNoteForNormalPitch),
           attackTime(static_cast<float>(attackTimeSecs)),
           releaseTime(static_cast<float>(releaseTimeSecs)),
-          originalBPM(originalBPM)
+          originalBPM(originalBPM),
+          pooled(std::move(sample))
     {
-        // Load the audio data
-        if (source.lengthInSamples > 0)
-        {
-            length = juce::jmin((int)source.lengthInSamples,
-                                (int)(maxSampleLengthSeconds * source.sampleRate));
+        const auto& head = pooled->getHead();
+        sourceSampleRate = head.getSampleRate();
+        length = static_cast<int>(std::min<juce::int64>(head.getLength(), std::numeric_limits<int>::max()));
+        data = &head.getHead();
+    }
 
-            data.reset(new juce::AudioBuffer<float>(juce::jmin(2, (int)source.numChannels), length + 4));
-            source.read(data.get(), 0, length + 4, 0, true, true);
-        }
+    // Zone of a memory-mapped bank: refers to the bank's PCM, nothing is copied
+    TempoSyncSamplerSound(const juce::String& soundName,
+                          std::shared_ptr<const SampleBank> sourceBank,
+                          const SampleBank::Zone& zone,
+                          const juce::BigInteger& midiNotes,
+                          double attackTimeSecs,
+                          double releaseTimeSecs,
+                          double originalBPM)
+        : name(soundName),
+          sourceSampleRate(zone.sampleRate),
+          midiNotes(midiNotes),
+          length(static_cast<int>(zone.numFrames)),
+          midiRootNote(zone.rootNote),
+          attackTime(static_cast<float>(attackTimeSecs)),
+          releaseTime(static_cast<float>(releaseTimeSecs)),
+          originalBPM(originalBPM),
+          bank(std::move(sourceBank))
+    {
+        const float* channels[2] = { bank->getChannelData(zone, 0), bank->getChannelData(zone, 1) };
+        bankView = CompactSampleBuffer::viewOf(channels, static_cast<int>(zone.numChannels),
+                                               length + SampleBankFormat::GUARD_FRAMES);
+        data = &bankView;
+    }
+
+    // Zone of a lazily loaded instrument: no audio until a note asks for it
+    TempoSyncSamplerSound(const juce::String& soundName,
+                          std::shared_ptr<LazyZoneMap> zoneMap,
+                          int index,
+                          const juce::BigInteger& midiNotes,
+                          double attackTimeSecs,
+                          double releaseTimeSecs,
+                          double originalBPM)
+        : name(soundName),
+          midiNotes(midiNotes),
+          midiRootNote(zoneMap->getZone(index).rootNote),
+          attackTime(static_cast<float>(attackTimeSecs)),
+          releaseTime(static_cast<float>(releaseTimeSecs)),
+          originalBPM(originalBPM),
+          lazyZones(std::move(zoneMap)),
+          zoneIndex(index)
+    {
     }
 
     bool appliesToNote(int midiNoteNumber) override { return midiNotes[midiNoteNumber]; }
@@ -59,14 +104,39 @@ public:
 
     double getOriginalBPM() const { return originalBPM; }
     int getMidiNoteForNormalPitch() const { return midiRootNote; }
-    juce::AudioBuffer<float>* getAudioData() const { return data.get(); }
+    const CompactSampleBuffer* getAudioData() const { return data; }
+    PooledSample* getPooledSample() const { return pooled.get(); }
+    int getLength() const { return length; }
+
+    /**
+     * Audio thread: the pooled sample a note should play and the root note it
+     * was recorded at. A lazy zone that hasn't loaded yet stands in with its
+     * nearest loaded neighbour. nullptr for bank zones, or if nothing is in.
+     */
+    PooledSample* resolvePooledSample(int midiNote, int& rootNote) const
+    {
+        rootNote = midiRootNote;
+        if (lazyZones != nullptr)
+            return lazyZones->resolve(zoneIndex, midiNote, rootNote);
+        return pooled.get();
+    }
+
+    size_t getResidentBytes() const
+    {
+        if (pooled != nullptr)
+            return pooled->getResidentBytes();
+        if (lazyZones != nullptr)
+            if (const auto* sample = lazyZones->getLoadedSample(zoneIndex))
+                return sample->getResidentBytes();
+        return 0;   // Banks are paged in and out by the OS
+    }
     float getAttackTime() const { return attackTime; }
     float getReleaseTime() const { return releaseTime; }
     double getSourceSampleRate() const { return sourceSampleRate; }
 
 private:
     juce::String name;
-    std::unique_ptr<juce::AudioBuffer<float>> data;
+    const CompactSampleBuffer* data = nullptr;
     double sourceSampleRate = 44100.0;
     juce::BigInteger midiNotes;
     int length = 0;
@@ -74,6 +144,11 @@ private:
     float attackTime = 0.01f;
     float releaseTime = 0.1f;
     double originalBPM = 120.0;
+    std::shared_ptr<PooledSample> pooled;
+    std::shared_ptr<const SampleBank> bank;
+    CompactSampleBuffer bankView;
+    std::shared_ptr<LazyZoneMap> lazyZones;
+    int zoneIndex = -1;
 };
 
 /**
@@ -108,6 +183,9 @@ public:
         updatePitchRatio();
     }
 
+    // Disk stream used when the playing sound is streamed (owned by SampleStreamer)
+    void setStream(SampleStreamer::Stream* newStream) { stream = newStream; }
+
     bool canPlaySound(juce::SynthesiserSound* sound) override
     {
         return dynamic_cast<TempoSyncSamplerSound*>(sound) != nullptr;
@@ -122,14 +200,23 @@ public:
             currentPitchWheel = currentPitchWheelPosition;
             currentVelocity = velocity;
 
+            // May be a neighbouring zone standing in for one still loading
+            int rootNote = sound->getMidiNoteForNormalPitch();
+            double sourceRate = sound->getSourceSampleRate();
+            if (!attachSource(*sound, midiNoteNumber, rootNote, sourceRate))
+            {
+                clearCurrentNote();     // Lazy zone with nothing loaded to stand in yet
+                return;
+            }
+
             // Sample rate conversion ratio
-            baseSampleRateRatio = sound->getSourceSampleRate() / getSampleRate();
+            baseSampleRateRatio = sourceRate / getSampleRate();
 
             // Standard sampler pitch tracking:
             // Root note (60 = C4) plays at original pitch
             // Each semitone up/down changes pitch by 2^(1/12)
             // This is the traditional "repitch" behavior used in samplers like Kontakt
-            baseFrequencyRatio = std::pow(2.0, (midiNoteNumber - sound->getMidiNoteForNormalPitch()) / 12.0);
+            baseFrequencyRatio = std::pow(2.0, (midiNoteNumber - rootNote) / 12.0);
 
             updatePitchRatio();
 
@@ -143,7 +230,7 @@ public:
             adsr.noteOn(velocity);
 
             DBG("Note ON - MIDI: " + juce::String(midiNoteNumber) +
-                " Root: " + juce::String(sound->getMidiNoteForNormalPitch()) +
+                " Root: " + juce::String(rootNote) +
                 " Freq Ratio: " + juce::String(baseFrequencyRatio) +
                 " Pitch Ratio: " + juce::String(pitchRatio) +
                 " Env Enabled: " + juce::String(envParams.enabled ? "YES" : "NO"));
@@ -165,7 +252,7 @@ public:
         }
         else
         {
-            clearCurrentNote();
+            endNote();
             adsr.reset();
         }
     }
@@ -183,56 +270,189 @@ public:
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
                          int startSample, int numSamples) override
     {
-        if (auto* sound = dynamic_cast<TempoSyncSamplerSound*>(getCurrentlyPlayingSound().get()))
+        if (getCurrentlyPlayingSound() != nullptr)
         {
-            auto& data = *sound->getAudioData();
-            const float* const inL = data.getReadPointer(0);
-            const float* const inR = data.getNumChannels() > 1 ? data.getReadPointer(1) : inL;
+            if (streamedSample != nullptr)
+            {
+                // Everything before the play head can be recycled by the I/O thread
+                stream->setPlayPosition(static_cast<juce::int64>(sourceSamplePosition));
+                const juce::int64 readable = stream->getReadableFrames();
 
-            float* outL = outputBuffer.getWritePointer(0, startSample);
-            float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
+                const bool starved = renderFrames(
+                    [this](int channel, juce::int64 frame) { return stream->read(*streamedSample, channel, frame); },
+                    readable, streamedSample->getLength(), outputBuffer, startSample, numSamples);
 
-            while (--numSamples >= 0)
+                if (starved)
+                    stream->reportUnderrun();
+            }
+            else if (residentData != nullptr)
             {
-                auto pos = (int)sourceSamplePosition;
-                auto alpha = (float)(sourceSamplePosition - pos);
-                auto invAlpha = 1.0f - alpha;
+                renderResident(*residentData, outputBuffer, startSample, numSamples);
+            }
+        }
+    }
 
-                // Linear interpolation
-                float l = 0, r = 0;
+private:
+    static constexpr int DECODE_FRAMES = 1024;  // Per-channel scratch for integer-stored samples
 
-                if (pos < data.getNumSamples() - 1)
-                {
-                    l = (inL[pos] * invAlpha + inL[pos + 1] * alpha);
-                    r = (inR[pos] * invAlpha + inR[pos + 1] * alpha);
-                }
+    void renderResident(const CompactSampleBuffer& data, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
+        const juce::int64 frames = data.getNumFrames();
 
-                // Always apply envelope - when ENV button is off, default values are used
-                float envelopeValue = adsr.process();
+        if (const float* inL = data.getFloatPointer(0))
+        {
+            const float* inR = data.getFloatPointer(1);
+            renderFrames([inL, inR](int channel, juce::int64 frame) { return (channel == 0 ? inL : inR)[frame]; },
+                         frames, frames, outputBuffer, startSample, numSamples);
+            return;
+        }
 
-                l *= lgain * envelopeValue;
-                r *= rgain * envelopeValue;
+        // Integer storage: convert the span of frames each chunk reads in one
+        // vectorised pass, then interpolate from float as usual
+        const bool stereo = data.getNumChannels() > 1;
+        const int maxChunk = juce::jmax(1, static_cast<int>((DECODE_FRAMES - 4) / juce::jmax(1.0, pitchRatio)));
 
-                *outL++ += l;
-                if (outR != nullptr)
-                    *outR++ += r;
+        while (numSamples > 0 && residentData != nullptr)   // endNote() clears residentData
+        {
+            const int n = juce::jmin(numSamples, maxChunk);
+            const auto first = static_cast<juce::int64>(sourceSamplePosition);
+            const auto last = static_cast<juce::int64>(sourceSamplePosition + (n - 1) * pitchRatio) + 3;
+            const int span = static_cast<int>(juce::jlimit<juce::int64>(0, DECODE_FRAMES, std::min(last, frames) - first));
 
-                sourceSamplePosition += pitchRatio;
+            if (span > 0)
+            {
+                data.decode(0, first, span, decodeScratch[0].data());
+                if (stereo)
+                    data.decode(1, first, span, decodeScratch[1].data());
+            }
 
-                // Check if sample ended or envelope finished
-                bool sampleEnded = sourceSamplePosition >= data.getNumSamples() - 1;
-                bool envEnded = !adsr.isActive();
+            const float* inL = decodeScratch[0].data();
+            const float* inR = stereo ? decodeScratch[1].data() : inL;
+            renderFrames([inL, inR, first](int channel, juce::int64 frame) { return (channel == 0 ? inL : inR)[frame - first]; },
+                         first + span, frames, outputBuffer, startSample, n);
 
-                if (sampleEnded || envEnded)
+            startSample += n;
+            numSamples -= n;
+        }
+    }
+
+    /**
+     * Interpolate frames [0, length) through `frameAt`. Frames at or beyond
+     * `readable` have not been streamed in yet; those samples are silent.
+     * Returns true if the play head ran into unread frames.
+     */
+    template <typename FrameSource>
+    bool renderFrames(FrameSource&& frameAt, juce::int64 readable, juce::int64 length,
+                      juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
+        float* outL = outputBuffer.getWritePointer(0, startSample);
+        float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
+        bool starved = false;
+
+        while (--numSamples >= 0)
+        {
+            auto pos = static_cast<juce::int64>(sourceSamplePosition);
+            auto alpha = (float)(sourceSamplePosition - static_cast<double>(pos));
+            auto invAlpha = 1.0f - alpha;
+
+            // Linear interpolation
+            float l = 0, r = 0;
+
+            if (pos < length - 1)
+            {
+                if (pos + 1 < readable)
+                {
+                    l = (frameAt(0, pos) * invAlpha + frameAt(0, pos + 1) * alpha);
+                    r = (frameAt(1, pos) * invAlpha + frameAt(1, pos + 1) * alpha);
+                }
+                else
                 {
-                    clearCurrentNote();
-                    break;
+                    starved = true;
                 }
             }
+
+            // Always apply envelope - when ENV button is off, default values are used
+            float envelopeValue = adsr.process();
+
+            l *= lgain * envelopeValue;
+            r *= rgain * envelopeValue;
+
+            *outL++ += l;
+            if (outR != nullptr)
+                *outR++ += r;
+
+            sourceSamplePosition += pitchRatio;
+
+            // Check if sample ended or envelope finished
+            bool sampleEnded = sourceSamplePosition >= static_cast<double>(length - 1);
+            bool envEnded = !adsr.isActive();
+
+            if (sampleEnded || envEnded)
+            {
+                endNote();
+                break;
+            }
         }
+
+        return starved;
+    }
+
+    /**
+     * Pick where this note reads from, and report the root note and rate of
+     * what it found. A pooled sample is pinned until the note ends, so its
+     * full copy can't be freed under the voice; if the pool has evicted that
+     * copy the note streams past the head instead. False if there is nothing
+     * to play.
+     */
+    bool attachSource(TempoSyncSamplerSound& sound, int midiNote, int& rootNote, double& sourceRate)
+    {
+        detachSource();
+
+        if (auto* sample = sound.resolvePooledSample(midiNote, rootNote))
+        {
+            pooled = sample;
+            sourceRate = pooled->getHead().getSampleRate();
+            if (const auto* full = pooled->beginUse())
+                residentData = &full->data;
+            else if (pooled->isShort() || stream == nullptr)
+                residentData = &pooled->getHead().getHead();
+            else
+                streamedSample = &pooled->getHead();
+        }
+        else
+        {
+            residentData = sound.getAudioData();
+        }
+
+        if (stream != nullptr)
+        {
+            if (streamedSample != nullptr)
+                stream->start(streamedSample);
+            else
+                stream->stop();
+        }
+
+        return residentData != nullptr || streamedSample != nullptr;
+    }
+
+    void detachSource()
+    {
+        if (stream != nullptr)
+            stream->stop();
+        if (pooled != nullptr)
+            pooled->endUse();
+
+        pooled = nullptr;
+        residentData = nullptr;
+        streamedSample = nullptr;
+    }
+
+    void endNote()
+    {
+        detachSource();
+        clearCurrentNote();
     }
 
-private:
     void updatePitchRatio()
     {
         // Standard repitch calculation:
@@ -293,42 +513,173 @@ private:
 
     DSP::ADSR adsr;  // Using our custom ADSR with curve support
     SampleEnvelopeParams envParams;
+    SampleStreamer::Stream* stream = nullptr;
+
+    // Source of the current note, set by attachSource()
+    PooledSample* pooled = nullptr;
+    const CompactSampleBuffer* residentData = nullptr;
+    const StreamedSample* streamedSample = nullptr;
+    std::array<std::array<float, DECODE_FRAMES>, 2> decodeScratch {};
 };
 
 /**
  * Sample synth with tempo sync support
  * Matches sample playback to DAW tempo
+ * Samples longer than the preload head are streamed from disk; each voice
+ * has its own stream. Decoded audio comes from the process-wide SamplePool,
+ * so instances playing the same preset share one copy.
+ *
+ * Preset loads never touch the playing instrument. There are two instrument
+ * slots, each a Synthesiser with its own voices. A loader thread builds the
+ * requested preset into the idle slot and marks it ready. processBlock()
+ * swaps slots at the next block boundary, and the previous instrument's
+ * notes fade out over the crossfade time. The loader then frees its sounds,
+ * so nothing is allocated or released on the audio thread. If requests
+ * arrive faster than they load, only the latest is built.
+ *
+ * Multisampled presets load lazily by default: only the zone nearest middle
+ * C is read before the swap, and the loader fetches the others as notes ask
+ * for them (see LazyZoneMap).
  */
 class SampleSynth
 {
 public:
+    static constexpr int NUM_VOICES = 16;               // Per instrument slot
+    static constexpr float MIN_CROSSFADE_MS = 5.0f;     // Old notes never stop harder than this
+
     SampleSynth()
+        : streamer(NUM_VOICES * NUM_SLOTS),
+          loader(*this)
     {
-        // Register audio formats we can read
-        formatManager.registerBasicFormats();
+        // Add tempo-sync voices to each slot's synthesiser
+        for (int s = 0; s < NUM_SLOTS; ++s)
+        {
+            for (int i = 0; i < NUM_VOICES; ++i)
+            {
+                auto* voice = new TempoSyncSamplerVoice();
+                voice->setStream(streamer.getStream(s * NUM_VOICES + i));
+                slots[static_cast<size_t>(s)].synth.addVoice(voice);
+            }
+        }
 
-        // Add tempo-sync voices to the synthesiser
-        for (int i = 0; i < 16; ++i)
-            synth.addVoice(new TempoSyncSamplerVoice());
+        slots[0].state.store(SlotActive);
+        fadeBuffer.setSize(2, 512);
+        loader.startThread(juce::Thread::Priority::normal);
+    }
+
+    ~SampleSynth()
+    {
+        loader.stopThread(4000);
+        for (auto& slot : slots)
+            slot.synth.allNotesOff(0, false);
+        streamer.stopAll();
+
+        // Pooled samples go back to the pool while it is still alive
+        for (auto& slot : slots)
+        {
+            slot.synth.clearSounds();
+            slot.zones.reset();
+        }
     }
 
     void prepare(double sampleRate, int samplesPerBlock)
     {
-        synth.setCurrentPlaybackSampleRate(sampleRate);
+        for (auto& slot : slots)
+            slot.synth.setCurrentPlaybackSampleRate(sampleRate);
         this->sampleRate = sampleRate;
+        fadeBuffer.setSize(2, juce::jmax(1, samplesPerBlock));
+        streamer.prepare(sampleRate, samplesPerBlock);
+    }
+
+    /**
+     * Stream samples from disk instead of loading them whole (applies to the next load).
+     * preloadMs is how much of each sample stays resident to cover disk latency.
+     */
+    void setStreamingEnabled(bool enabled, float preloadMs = SampleStreamer::DEFAULT_PRELOAD_MS)
+    {
+        const juce::ScopedLock sl(optionsLock);
+        loadOptions.streaming = enabled;
+        loadOptions.preloadMs = juce::jmax(10.0f, preloadMs);
+    }
+
+    bool isStreamingEnabled() const
+    {
+        const juce::ScopedLock sl(optionsLock);
+        return loadOptions.streaming;
+    }
+
+    /**
+     * Keep 16- and 24-bit samples at their own width in memory (applies to the
+     * next load). Voices convert to float as they read, so this is lossless
+     * and on by default; float sources are always stored as float.
+     */
+    void setCompactStorageEnabled(bool enabled)
+    {
+        const juce::ScopedLock sl(optionsLock);
+        loadOptions.compact = enabled;
+    }
+
+    bool isCompactStorageEnabled() const
+    {
+        const juce::ScopedLock sl(optionsLock);
+        return loadOptions.compact;
+    }
+
+    /**
+     * Load the zones of multisampled presets when they are first played
+     * rather than up front (applies to the next load). Off, every zone is
+     * decoded before the preset is swapped in.
+     */
+    void setLazyZoneLoadingEnabled(bool enabled)
+    {
+        const juce::ScopedLock sl(optionsLock);
+        lazyZones = enabled;
+    }
+
+    bool isLazyZoneLoadingEnabled() const
+    {
+        const juce::ScopedLock sl(optionsLock);
+        return lazyZones;
+    }
+
+    // How long notes of the previous preset take to fade out after a switch
+    void setPresetCrossfadeMs(float ms) { crossfadeMs.store(juce::jmax(MIN_CROSSFADE_MS, ms), std::memory_order_relaxed); }
+    float getPresetCrossfadeMs() const { return crossfadeMs.load(std::memory_order_relaxed); }
+
+    uint32_t getStreamUnderrunCount() const { return streamer.getUnderrunCount(); }
+    int getActiveStreamCount() const { return streamer.getActiveStreamCount(); }
+
+    // Sample memory referenced by the playing instrument (possibly shared with other instances)
+    size_t getResidentBytes() const
+    {
+        const auto& synth = activeSynth();
+        size_t total = 0;
+        for (int i = 0; i < synth.getNumSounds(); ++i)
+            if (auto* sound = dynamic_cast<TempoSyncSamplerSound*>(synth.getSound(i).get()))
+                total += sound->getResidentBytes();
+        return total;
     }
 
+    /**
+     * Process-wide ceiling for decoded sample memory. Over it, the least
+     * recently played zones drop their full copy and stream from disk until
+     * they are played again and fit.
+     */
+    void setMemoryBudget(size_t bytes) { samplePool->setMemoryBudget(bytes); }
+    void setIdleEvictionSeconds(int seconds) { samplePool->setIdleEvictionSeconds(seconds); }
+
+    // Pool-wide counters (all instances)
+    size_t getPoolResidentBytes() const { return samplePool->getResidentBytes(); }
+    juce::uint64 getEvictionCount() const { return samplePool->getEvictionCount(); }
+    juce::uint64 getReloadCount() const { return samplePool->getReloadCount(); }
+
     /**
      * Set the host BPM for tempo sync
      */
     void setHostBPM(double bpm)
     {
         hostBPM = bpm;
-        for (int i = 0; i < synth.getNumVoices(); ++i)
-        {
-            if (auto* voice = dynamic_cast<TempoSyncSamplerVoice*>(synth.getVoice(i)))
-                voice->setHostBPM(bpm);
-        }
+        forEachVoice([bpm](TempoSyncSamplerVoice& voice) { voice.setHostBPM(bpm); });
     }
 
     /**
@@ -337,11 +688,7 @@ public:
     void setTempoSyncEnabled(bool enabled)
     {
         tempoSyncEnabled = enabled;
-        for (int i = 0; i < synth.getNumVoices(); ++i)
-        {
-            if (auto* voice = dynamic_cast<TempoSyncSamplerVoice*>(synth.getVoice(i)))
-                voice->setTempoSyncEnabled(enabled);
-        }
+        forEachVoice([enabled](TempoSyncSamplerVoice& voice) { voice.setTempoSyncEnabled(enabled); });
     }
 
     /**
@@ -353,141 +700,184 @@ public:
     }
 
     /**
-     * Load a sample file and make it playable across all MIDI notes
+     * Load a sample file and make it playable across all MIDI notes.
+     * Loads in the background; the current instrument plays until it is ready.
      */
     bool loadSample(const juce::File& file)
     {
-        // Clear any existing sounds
-        synth.clearSounds();
-
-        // Create a reader for the file
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
-
-        if (reader == nullptr)
-        {
-            DBG("Failed to create reader for: " + file.getFullPathName());
-            return false;
-        }
-
-        DBG("Loading sample: " + file.getFullPathName());
-        DBG("  Sample rate: " + juce::String(reader->sampleRate));
-        DBG("  Length: " + juce::String(reader->lengthInSamples) + " samples");
-        DBG("  Channels: " + juce::String(reader->numChannels));
-
-        // Try to detect BPM from filename (common format: "SampleName_120BPM.wav")
-        double detectedBPM = detectBPMFromFilename(file.getFileNameWithoutExtension());
-        if (detectedBPM <= 0)
-            detectedBPM = originalBPM; // Use default if not detected
-
-        DBG("  Original BPM: " + juce::String(detectedBPM));
-
-        // Create a BigInteger for which MIDI notes this sample responds to (all notes)
-        juce::BigInteger allNotes;
-        allNotes.setRange(0, 128, true);
-
-        // Create the TempoSyncSamplerSound with BPM info
-        synth.addSound(new TempoSyncSamplerSound(
-            file.getFileNameWithoutExtension(),  // name
-            *reader,                              // source reader
-            allNotes,                             // notes this sample plays on
-            60,                                   // root note (C4 - middle C)
-            0.01,                                 // attack time in seconds
-            0.1,                                  // release time in seconds
-            30.0,                                 // max sample length in seconds
-            detectedBPM                           // original BPM
-        ));
-
-        currentSampleFile = file;
+        LoadRequest request;
+        request.kind = LoadRequest::Kind::Sample;
+        request.file = file;
+        loader.request(std::move(request));
         return true;
     }
 
     /**
      * Load multiple samples with specified key zones (for multisampled instruments)
-     * Each zone has: file, rootNote, lowKey, highKey
+     * Each zone has: file, rootNote, lowKey, highKey. Loads in the background.
      */
     bool loadMultisampledPreset(const std::vector<std::tuple<juce::File, int, int, int>>& zones)
     {
-        // Clear any existing sounds
-        synth.clearSounds();
-
         if (zones.empty())
             return false;
 
-        DBG("Loading multisampled preset with " + juce::String(zones.size()) + " zones");
+        LoadRequest request;
+        request.kind = LoadRequest::Kind::Zones;
+        request.zones = zones;
+        loader.request(std::move(request));
+        return true;
+    }
 
-        for (const auto& [file, rootNote, lowKey, highKey] : zones)
-        {
-            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    /**
+     * Load one preset of a packed bank. The zones point straight into the
+     * mapped file; no sample data is read or decoded here.
+     */
+    bool loadBankPreset(const std::shared_ptr<const SampleBank>& bank, int presetIndex)
+    {
+        if (bank == nullptr || presetIndex < 0 || presetIndex >= bank->getNumPresets())
+            return false;
 
-            if (reader == nullptr)
-            {
-                DBG("  Failed to load zone: " + file.getFullPathName());
-                continue;
-            }
+        LoadRequest request;
+        request.kind = LoadRequest::Kind::Bank;
+        request.bank = bank;
+        request.bankPresetIndex = presetIndex;
+        loader.request(std::move(request));
+        return true;
+    }
 
-            DBG("  Zone: root=" + juce::String(rootNote) +
-                " range=" + juce::String(lowKey) + "-" + juce::String(highKey) +
-                " file=" + file.getFileName());
+    // Switch to an empty instrument (fades out like any preset change)
+    void clearSample()
+    {
+        loader.request(LoadRequest {});
+    }
 
-            // Create a BigInteger for the key range this sample responds to
-            juce::BigInteger noteRange;
-            noteRange.setRange(lowKey, highKey - lowKey + 1, true);
+    // True while a requested preset hasn't been swapped in yet
+    bool isLoadPending() const
+    {
+        return loader.isBusy() || standbySlot().state.load(std::memory_order_acquire) == SlotReady;
+    }
 
-            // Create the sound with the correct root note
-            synth.addSound(new TempoSyncSamplerSound(
-                file.getFileNameWithoutExtension(),
-                *reader,
-                noteRange,
-                rootNote,  // The MIDI note this sample was recorded at
-                0.01,      // attack
-                0.1,       // release
-                30.0,      // max length
-                120.0      // BPM (default)
-            ));
-        }
+    /**
+     * How far the preset being built has got (zones decoded / zones), for
+     * the UI. -1 when no load is running.
+     */
+    float getLoadProgress() const
+    {
+        if (!loader.isBusy())
+            return -1.0f;
 
-        if (!zones.empty())
-            currentSampleFile = std::get<0>(zones[0]);
+        const int total = loadTotal.load(std::memory_order_relaxed);
+        return total > 0 ? juce::jlimit(0.0f, 1.0f, static_cast<float>(loadDone.load(std::memory_order_relaxed)) / static_cast<float>(total))
+                         : 0.0f;
+    }
 
-        return synth.getNumSounds() > 0;
+    /**
+     * Audio thread: block until the requested preset is ready to be swapped
+     * in. For offline rendering, where the first block must already use the
+     * new preset. A previous instrument still fading out is cut off first, so
+     * the loader can take its slot.
+     */
+    bool waitForPendingLoad(int timeoutMs)
+    {
+        if (fadingSlot >= 0)
+            retireFadingSlot();
+
+        const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+        while (loader.isBusy())
+        {
+            if (juce::Time::getMillisecondCounter() >= deadline)
+                return false;
+            loader.loaded.wait(10);
+        }
+        return true;
     }
 
-    void clearSample()
+    /**
+     * Audio thread: block until every zone of the instrument this block plays
+     * is in. For offline rendering, which must not use stand-ins for lazy zones.
+     */
+    bool waitForAllZones(int timeoutMs)
     {
-        synth.clearSounds();
-        currentSampleFile = juce::File();
+        // A ready instrument would be swapped in by processBlock() anyway
+        swapInReadyInstrument();
+
+        auto* zones = activeSlot().zones.get();
+        if (zones == nullptr || zones->isFullyLoaded())
+            return true;
+
+        zones->requestAll();
+        loader.poke();
+
+        const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+        while (!zones->isFullyLoaded())
+        {
+            if (juce::Time::getMillisecondCounter() >= deadline)
+                return false;
+            zonesLoaded.wait(10);
+        }
+        return true;
     }
 
     void noteOn(int midiChannel, int midiNote, float velocity)
     {
         // Apply velocity curve before passing to synth
         velocity = std::pow(velocity, velocityCurve);
-        synth.noteOn(midiChannel, midiNote, velocity);
+        activeSynth().noteOn(midiChannel, midiNote, velocity);
     }
 
     void noteOff(int midiChannel, int midiNote, float velocity)
     {
-        synth.noteOff(midiChannel, midiNote, velocity, true);
+        activeSynth().noteOff(midiChannel, midiNote, velocity, true);
     }
 
     void allNotesOff()
     {
-        synth.allNotesOff(0, true);
+        activeSynth().allNotesOff(0, true);
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
     {
-        synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+        swapInReadyInstrument();
+
+        activeSynth().renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+
+        // Notes have asked for zones that aren't loaded yet
+        if (auto* zones = activeSlot().zones.get(); zones != nullptr && zones->takeWakeUp())
+            loader.poke();
+
+        if (fadingSlot >= 0)
+            renderFadeOut(buffer);
+    }
+
+    // Also true while an instrument swap or fade-out is pending, so the host block loop keeps running
+    bool isAnyVoiceActive() const
+    {
+        if (fadingSlot >= 0 || standbySlot().state.load(std::memory_order_acquire) == SlotReady)
+            return true;
+
+        const auto& synth = activeSynth();
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+        {
+            if (synth.getVoice(i)->isVoiceActive())
+                return true;
+        }
+        return false;
     }
 
+    // Both describe the instrument that is playing, not one still being built or swapped in
     bool hasSampleLoaded() const
     {
-        return synth.getNumSounds() > 0;
+        const juce::ScopedLock sl(infoLock);
+        return activeSlot().info.hasSounds;
     }
 
     juce::String getCurrentSampleName() const
     {
-        return currentSampleFile.getFileNameWithoutExtension();
+        const juce::ScopedLock sl(infoLock);
+        const auto& info = activeSlot().info;
+        if (info.bankPresetName.isNotEmpty())
+            return info.bankPresetName;
+        return info.file.getFileNameWithoutExtension();
     }
 
     bool isTempoSyncEnabled() const { return tempoSyncEnabled; }
@@ -501,22 +891,14 @@ public:
     void setEnvelopeParams(const SampleEnvelopeParams& params)
     {
         envParams = params;
-        for (int i = 0; i < synth.getNumVoices(); ++i)
-        {
-            if (auto* voice = dynamic_cast<TempoSyncSamplerVoice*>(synth.getVoice(i)))
-                voice->setEnvelopeParams(params);
-        }
+        forEachVoice([&params](TempoSyncSamplerVoice& voice) { voice.setEnvelopeParams(params); });
     }
 
     const SampleEnvelopeParams& getEnvelopeParams() const { return envParams; }
 
     void setPitchBendRange(int semitones)
     {
-        for (int i = 0; i < synth.getNumVoices(); ++i)
-        {
-            if (auto* voice = dynamic_cast<TempoSyncSamplerVoice*>(synth.getVoice(i)))
-                voice->setPitchBendRange(semitones);
-        }
+        forEachVoice([semitones](TempoSyncSamplerVoice& voice) { voice.setPitchBendRange(semitones); });
     }
 
     void setVelocityCurve(float curve)
@@ -527,6 +909,449 @@ public:
     float getVelocityCurve() const { return velocityCurve; }
 
 private:
+    static constexpr int NUM_SLOTS = 2;
+
+    // Slot ownership: Idle/Loading belong to the loader, Ready hands over, Active/Fading belong to the audio thread
+    enum SlotState { SlotIdle, SlotLoading, SlotReady, SlotActive, SlotFading };
+
+    struct Slot
+    {
+        juce::Synthesiser synth;
+        std::atomic<int> state { SlotIdle };
+
+        // Written by the loader while it owns the slot
+        juce::File file;
+        juce::String bankPresetName;
+        std::shared_ptr<LazyZoneMap> zones;     // Lazily loaded multisampled preset
+
+        // What the slot holds, for the UI; published by build() under infoLock
+        struct Info
+        {
+            juce::File file;
+            juce::String bankPresetName;    // The bank file alone doesn't name the preset
+            bool hasSounds = false;
+        } info;
+    };
+
+    struct LoadRequest
+    {
+        enum class Kind { Clear, Sample, Zones, Bank };
+
+        Kind kind = Kind::Clear;
+        juce::File file;
+        std::vector<std::tuple<juce::File, int, int, int>> zones;
+        std::shared_ptr<const SampleBank> bank;
+        int bankPresetIndex = -1;
+    };
+
+    /** Background thread that builds instruments and frees retired ones */
+    class Loader : public juce::Thread
+    {
+    public:
+        explicit Loader(SampleSynth& o) : juce::Thread("Sample preset loader"), owner(o) {}
+
+        void request(LoadRequest newRequest)
+        {
+            {
+                const juce::ScopedLock sl(lock);
+                pending = std::move(newRequest);
+                hasRequest = true;
+                busy.store(true, std::memory_order_release);
+            }
+            notify();
+        }
+
+        bool isBusy() const { return busy.load(std::memory_order_acquire); }
+
+        // Audio thread: ask for a pass soon. Polled, because notify() takes a lock.
+        void poke() { poked.store(true, std::memory_order_release); }
+
+        // True once the job being built is out of date; its remaining zones are skipped
+        bool isSuperseded() const
+        {
+            const juce::ScopedLock sl(lock);
+            return hasRequest || threadShouldExit();
+        }
+
+        void run() override
+        {
+            auto lastPass = juce::Time::getMillisecondCounter();
+            while (!threadShouldExit())
+            {
+                const bool notified = wait(POLL_INTERVAL_MS);
+                const bool wasPoked = poked.exchange(false, std::memory_order_acq_rel);
+                const auto now = juce::Time::getMillisecondCounter();
+                if (!notified && !wasPoked && now - lastPass < IDLE_PASS_MS)
+                    continue;
+                lastPass = now;
+
+                // Zones the instruments' notes have asked for; a preset request comes first
+                owner.loadRequestedZones();
+
+                // The standby slot is ours once its fade-out has finished, or while it
+                // waits to be swapped in and a newer request has made it stale
+                auto& slot = owner.standbySlot();
+                int expected = SlotIdle;
+                if (!slot.state.compare_exchange_strong(expected, SlotLoading, std::memory_order_acq_rel))
+                {
+                    expected = SlotReady;
+                    if (!isBusy() || !slot.state.compare_exchange_strong(expected, SlotLoading, std::memory_order_acq_rel))
+                        continue;
+                }
+
+                // Free the previous instrument here, never on the audio thread
+                owner.streamer.synchronise();
+                slot.synth.clearSounds();
+                slot.zones.reset();
+
+                LoadRequest job;
+                bool haveJob = false;
+                {
+                    const juce::ScopedLock sl(lock);
+                    if (hasRequest)
+                    {
+                        job = std::move(pending);
+                        hasRequest = false;
+                        haveJob = true;
+                    }
+                }
+
+                if (!haveJob)
+                {
+                    slot.state.store(SlotIdle, std::memory_order_release);
+                    continue;
+                }
+
+                owner.build(slot, job);
+
+                // A newer request supersedes this one: build again rather than swapping twice
+                const juce::ScopedLock sl(lock);
+                if (hasRequest)
+                {
+                    slot.state.store(SlotIdle, std::memory_order_release);
+                    notify();
+                    continue;
+                }
+
+                slot.state.store(SlotReady, std::memory_order_release);
+                busy.store(false, std::memory_order_release);
+                loaded.signal();
+                notify();   // Come round again to prefetch its zones
+            }
+        }
+
+        juce::WaitableEvent loaded;
+
+    private:
+        static constexpr int POLL_INTERVAL_MS = 10;
+        static constexpr juce::uint32 IDLE_PASS_MS = 500;
+
+        SampleSynth& owner;
+        juce::CriticalSection lock;     // Also taken by decoder threads via isSuperseded()
+        LoadRequest pending;
+        bool hasRequest = false;
+        std::atomic<bool> busy { false };
+        std::atomic<bool> poked { false };
+    };
+
+    Slot& activeSlot() { return slots[static_cast<size_t>(activeIndex.load(std::memory_order_acquire))]; }
+    const Slot& activeSlot() const { return slots[static_cast<size_t>(activeIndex.load(std::memory_order_acquire))]; }
+    Slot& standbySlot() { return slots[static_cast<size_t>(1 - activeIndex.load(std::memory_order_acquire))]; }
+    const Slot& standbySlot() const { return slots[static_cast<size_t>(1 - activeIndex.load(std::memory_order_acquire))]; }
+    juce::Synthesiser& activeSynth() { return slots[static_cast<size_t>(activeIndex.load(std::memory_order_acquire))].synth; }
+    const juce::Synthesiser& activeSynth() const { return slots[static_cast<size_t>(activeIndex.load(std::memory_order_acquire))].synth; }
+
+    template <typename Fn>
+    void forEachVoice(Fn&& fn)
+    {
+        for (auto& slot : slots)
+            for (int i = 0; i < slot.synth.getNumVoices(); ++i)
+                if (auto* voice = dynamic_cast<TempoSyncSamplerVoice*>(slot.synth.getVoice(i)))
+                    fn(*voice);
+    }
+
+    // Audio thread, at the block boundary: make a ready instrument the active one
+    void swapInReadyInstrument()
+    {
+        // The standby slot is still fading out, so nothing can be ready in it yet
+        if (fadingSlot >= 0)
+            return;
+
+        // Claimed with a CAS: the loader may take back a ready slot to build a newer request
+        const int next = 1 - activeIndex.load(std::memory_order_relaxed);
+        int expected = SlotReady;
+        if (!slots[static_cast<size_t>(next)].state.compare_exchange_strong(expected, SlotActive, std::memory_order_acq_rel))
+            return;
+
+        fadingSlot = activeIndex.load(std::memory_order_relaxed);
+        slots[static_cast<size_t>(fadingSlot)].state.store(SlotFading, std::memory_order_relaxed);
+        activeIndex.store(next, std::memory_order_release);
+
+        fadeLength = juce::jmax(1, static_cast<int>(crossfadeMs.load(std::memory_order_relaxed) * 0.001 * sampleRate));
+        fadeRemaining = fadeLength;
+    }
+
+    // Audio thread: the previous instrument's notes, ramped down; retired once silent
+    void renderFadeOut(juce::AudioBuffer<float>& buffer)
+    {
+        auto& fading = slots[static_cast<size_t>(fadingSlot)];
+        const int numChannels = juce::jmin(buffer.getNumChannels(), fadeBuffer.getNumChannels());
+        const int total = juce::jmin(buffer.getNumSamples(), fadeRemaining);
+
+        for (int start = 0; start < total; start += fadeBuffer.getNumSamples())
+        {
+            const int n = juce::jmin(fadeBuffer.getNumSamples(), total - start);
+            fadeBuffer.clear();
+            fading.synth.renderNextBlock(fadeBuffer, noMidi, 0, n);
+
+            const float startGain = static_cast<float>(fadeRemaining) / static_cast<float>(fadeLength);
+            const float endGain = static_cast<float>(fadeRemaining - n) / static_cast<float>(fadeLength);
+            for (int c = 0; c < numChannels; ++c)
+                buffer.addFromWithRamp(c, start, fadeBuffer.getReadPointer(c), n, startGain, endGain);
+
+            fadeRemaining -= n;
+        }
+
+        if (fadeRemaining <= 0)
+            retireFadingSlot();
+    }
+
+    // Audio thread: hand the faded-out slot back to the loader
+    void retireFadingSlot()
+    {
+        // Voices let go of their sounds and streams; the loader frees the sounds
+        auto& fading = slots[static_cast<size_t>(fadingSlot)];
+        fading.synth.allNotesOff(0, false);
+        fading.state.store(SlotIdle, std::memory_order_release);
+        fadingSlot = -1;
+        fadeRemaining = 0;
+        loader.poke();
+    }
+
+    // Loader thread: fill a slot it owns with the requested instrument
+    void build(Slot& slot, const LoadRequest& job)
+    {
+        slot.file = juce::File();
+        slot.bankPresetName = {};
+
+        const bool lazy = isLazyZoneLoadingEnabled();
+        loadDone.store(0, std::memory_order_relaxed);
+        loadTotal.store(job.kind == LoadRequest::Kind::Zones && !lazy ? static_cast<int>(job.zones.size()) : 1, std::memory_order_relaxed);
+
+        switch (job.kind)
+        {
+            case LoadRequest::Kind::Sample:  buildSample(slot, job.file); break;
+            case LoadRequest::Kind::Zones:
+                if (lazy)
+                    buildLazyMultisampled(slot, job.zones);
+                else
+                    buildMultisampled(slot, job.zones);
+                break;
+            case LoadRequest::Kind::Bank:    buildBankPreset(slot, job.bank, job.bankPresetIndex); break;
+            case LoadRequest::Kind::Clear:   break;
+        }
+
+        loadDone.store(loadTotal.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        const juce::ScopedLock sl(infoLock);
+        slot.info = { slot.file, slot.bankPresetName, slot.synth.getNumSounds() > 0 };
+    }
+
+    void buildSample(Slot& slot, const juce::File& file)
+    {
+        DBG("Loading sample: " + file.getFullPathName());
+
+        // Try to detect BPM from filename (common format: "SampleName_120BPM.wav")
+        double detectedBPM = detectBPMFromFilename(file.getFileNameWithoutExtension());
+        if (detectedBPM <= 0)
+            detectedBPM = originalBPM; // Use default if not detected
+
+        DBG("  Original BPM: " + juce::String(detectedBPM));
+
+        // Create a BigInteger for which MIDI notes this sample responds to (all notes)
+        juce::BigInteger allNotes;
+        allNotes.setRange(0, 128, true);
+
+        // Create the TempoSyncSamplerSound with BPM info
+        auto* sound = createSound(file, allNotes, 60, detectedBPM);
+        if (sound == nullptr)
+        {
+            DBG("Failed to load: " + file.getFullPathName());
+            return;
+        }
+
+        slot.synth.addSound(sound);
+        slot.file = file;
+    }
+
+    /**
+     * Zones decode in parallel on the pool's decoder threads (this thread
+     * helps); with enough cores a preset takes about as long as its largest
+     * zone, which is started first. The sounds are added in zone order once
+     * all are in; a newer request stops the zones not yet started.
+     */
+    void buildMultisampled(Slot& slot, const std::vector<std::tuple<juce::File, int, int, int>>& zones)
+    {
+        DBG("Loading multisampled preset with " + juce::String(zones.size()) + " zones");
+
+        std::vector<juce::File> files;
+        files.reserve(zones.size());
+        for (const auto& zone : zones)
+            files.push_back(std::get<0>(zone));
+
+        auto samples = samplePool->acquireAll(files, currentLoadOptions(),
+                                              [this] { return loader.isSuperseded(); },
+                                              [this](int done) { loadDone.store(done, std::memory_order_relaxed); });
+        if (loader.isSuperseded())
+            return;     // Rebuilt for the newer request straight away
+
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            const auto& [file, rootNote, lowKey, highKey] = zones[i];
+            DBG("  Zone: root=" + juce::String(rootNote) +
+                " range=" + juce::String(lowKey) + "-" + juce::String(highKey) +
+                " file=" + file.getFileName());
+
+            if (samples[i] == nullptr)
+            {
+                DBG("  Failed to load zone: " + file.getFullPathName());
+                continue;
+            }
+
+            // Create a BigInteger for the key range this sample responds to
+            juce::BigInteger noteRange;
+            noteRange.setRange(lowKey, highKey - lowKey + 1, true);
+
+            // Create the sound with the correct root note
+            slot.synth.addSound(makeSound(file, std::move(samples[i]), noteRange, rootNote, 120.0));
+        }
+
+        if (!zones.empty())
+            slot.file = std::get<0>(zones[0]);
+    }
+
+    /**
+     * Zones go in as stubs; only the one nearest middle C is fetched now, so
+     * the preset can be swapped in after one zone instead of all of them.
+     * Its neighbours are prefetched once the preset is ready.
+     */
+    void buildLazyMultisampled(Slot& slot, const std::vector<std::tuple<juce::File, int, int, int>>& zones)
+    {
+        DBG("Loading multisampled preset with " + juce::String(zones.size()) + " lazy zones");
+
+        std::vector<LazyZoneMap::ZoneInfo> infos;
+        infos.reserve(zones.size());
+        for (const auto& [file, rootNote, lowKey, highKey] : zones)
+            infos.push_back({ file, rootNote, lowKey, highKey });
+
+        auto map = std::make_shared<LazyZoneMap>(infos, currentLoadOptions());
+
+        const int anchor = map->findAnchorZone();
+        map->publish(anchor, samplePool->acquire(map->getZone(anchor).file, map->getLoadOptions()));
+        map->prefetchAround(map->getZone(anchor).rootNote);
+
+        for (int i = 0; i < map->getNumZones(); ++i)
+        {
+            const auto& zone = map->getZone(i);
+
+            juce::BigInteger noteRange;
+            noteRange.setRange(zone.lowKey, zone.highKey - zone.lowKey + 1, true);
+
+            slot.synth.addSound(new TempoSyncSamplerSound(zone.file.getFileNameWithoutExtension(), map, i, noteRange,
+                                                          0.01, 0.1, 120.0));
+        }
+
+        slot.zones = std::move(map);
+        if (!zones.empty())
+            slot.file = std::get<0>(zones[0]);
+    }
+
+    /**
+     * Loader thread: fetch the zones notes are waiting for, then prefetch a
+     * batch at a time (one zone per decoder thread) so that a note arriving
+     * meanwhile doesn't queue behind the whole neighbourhood. Stops as soon
+     * as a preset request is pending.
+     */
+    void loadRequestedZones()
+    {
+        const int batch = juce::jmax(1, juce::SystemStats::getNumCpus());
+        bool fetched = true;
+
+        while (fetched && !loader.isSuperseded())
+        {
+            fetched = false;
+            for (auto& slot : slots)
+            {
+                const int state = slot.state.load(std::memory_order_acquire);
+                if (slot.zones == nullptr || (state != SlotActive && state != SlotReady))
+                    continue;
+
+                auto& zones = *slot.zones;
+                const auto indices = zones.takeRequests(batch);
+                if (indices.empty())
+                    continue;
+
+                std::vector<juce::File> files;
+                for (int index : indices)
+                    files.push_back(zones.getZone(index).file);
+
+                auto samples = samplePool->acquireAll(files, zones.getLoadOptions());
+                for (size_t k = 0; k < indices.size(); ++k)
+                    zones.publish(indices[k], std::move(samples[k]));
+
+                fetched = true;
+                zonesLoaded.signal();
+            }
+        }
+    }
+
+    void buildBankPreset(Slot& slot, const std::shared_ptr<const SampleBank>& bank, int presetIndex)
+    {
+        const auto& preset = bank->getPreset(presetIndex);
+        for (uint32_t z = 0; z < preset.numZones; ++z)
+        {
+            const auto& zone = bank->getZone(static_cast<int>(preset.firstZone + z));
+
+            juce::BigInteger noteRange;
+            noteRange.setRange(zone.lowKey, zone.highKey - zone.lowKey + 1, true);
+
+            slot.synth.addSound(new TempoSyncSamplerSound(bank->getZoneName(zone), bank, zone, noteRange,
+                                                          0.01, 0.1, 120.0));
+        }
+
+        slot.file = bank->getFile();
+        slot.bankPresetName = bank->getPresetName(presetIndex);
+    }
+
+    /**
+     * Build a sound for one file from the shared pool: streamed past the
+     * preload head, or read whole (up to 30 s, within the memory budget)
+     * when streaming is off. nullptr if the file can't be read.
+     */
+    TempoSyncSamplerSound* createSound(const juce::File& file, const juce::BigInteger& notes, int rootNote, double bpm)
+    {
+        auto sample = samplePool->acquire(file, currentLoadOptions());
+        if (!sample)
+            return nullptr;
+
+        return makeSound(file, std::move(sample), notes, rootNote, bpm);
+    }
+
+    static TempoSyncSamplerSound* makeSound(const juce::File& file, std::shared_ptr<PooledSample> sample,
+                                            const juce::BigInteger& notes, int rootNote, double bpm)
+    {
+        return new TempoSyncSamplerSound(file.getFileNameWithoutExtension(), std::move(sample), notes, rootNote,
+                                         0.01,   // attack
+                                         0.1,    // release
+                                         bpm);
+    }
+
+    SamplePool::LoadOptions currentLoadOptions() const
+    {
+        const juce::ScopedLock sl(optionsLock);
+        return loadOptions;
+    }
+
     /**
      * Try to detect BPM from filename
      * Looks for patterns like: "120BPM", "120_bpm", "120 bpm", "_120_"
@@ -592,15 +1417,38 @@ private:
         return 0; // Not detected
     }
 
-    juce::Synthesiser synth;
-    juce::AudioFormatManager formatManager;
+    // Declared before the slots: their sounds hand samples back to it when destroyed
+    juce::SharedResourcePointer<SamplePool> samplePool;
+
+    std::array<Slot, NUM_SLOTS> slots;
+    std::atomic<int> activeIndex { 0 };
+
+    // Audio thread fade-out state
+    int fadingSlot = -1;
+    int fadeLength = 1;
+    int fadeRemaining = 0;
+    juce::AudioBuffer<float> fadeBuffer;
+    juce::MidiBuffer noMidi;
+    std::atomic<float> crossfadeMs { 50.0f };
+
+    std::atomic<int> loadDone { 0 };
+    std::atomic<int> loadTotal { 0 };
+    juce::WaitableEvent zonesLoaded;
+    juce::CriticalSection optionsLock;
+    SamplePool::LoadOptions loadOptions;
+    bool lazyZones = true;
     double sampleRate = 44100.0;
     double hostBPM = 120.0;
     double originalBPM = 120.0;
     bool tempoSyncEnabled = true;
-    juce::File currentSampleFile;
     SampleEnvelopeParams envParams;
     float velocityCurve = 1.0f;
+
+    juce::CriticalSection infoLock;     // Guards every Slot::info
+
+    // Declared last: destroyed first, so the I/O and loader threads stop before the sounds
+    SampleStreamer streamer;
+    Loader loader;
 };
 
 } // namespace Engine
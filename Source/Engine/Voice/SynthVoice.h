@@ -3,11 +3,14 @@
 #include <JuceHeader.h>
 #include "../../DSP/Oscillators/Oscillator.h"
 #include "../../DSP/Oscillators/WavetableOscillator.h"
+#include "../../DSP/Oscillators/NoiseGenerator.h"
 #include "../../DSP/Filters/SVFFilter.h"
+#include "../../DSP/Filters/Oversampler.h"
 #include "../../DSP/Modulators/ADSR.h"
 #include "../../DSP/Modulators/LFO.h"
 #include "../../Modulation/ModMatrix.h"
 #include "../PCM/SamplePlayer.h"
+#include <utility>
 
 namespace NulyBeats {
 namespace Engine {
@@ -49,6 +52,7 @@ public:
 
         // Noise
         float noiseLevel = 0.0f;
+        DSP::NoiseGenerator::Colour noiseColour = DSP::NoiseGenerator::Colour::White;
 
         // Filter
         DSP::SVFFilter::Type filterType = DSP::SVFFilter::Type::LowPass;
@@ -82,22 +86,30 @@ public:
         float glideTime = 0.0f;
         bool glideAlways = false;
 
+        // Oscillator + filter oversampling: 1, 2 or 4 (latched when a voice starts)
+        int oversampling = 1;
+
         // Master
         float masterLevel = 1.0f;
     };
 
+    static constexpr int NOISE_CHUNK = 64;
+
+    // Early retirement: fade length once a voice has gone inaudible
+    static constexpr int RETIRE_FADE_SAMPLES = 64;
+
     SynthVoice() = default;
 
     void prepare(double sampleRate, int samplesPerBlock)
     {
         this->sampleRate = sampleRate;
+        this->samplesPerBlock = samplesPerBlock;
 
-        osc1.prepare(sampleRate, samplesPerBlock);
-        osc2.prepare(sampleRate, samplesPerBlock);
         wavetableOsc1.prepare(sampleRate, samplesPerBlock);
         wavetableOsc2.prepare(sampleRate, samplesPerBlock);
 
-        filter.prepare(sampleRate, samplesPerBlock);
+        // Oscillators and filter run at the oversampled rate
+        configureOversampling(oversampler.getFactor());
 
         ampEnv.prepare(sampleRate);
         filterEnv.prepare(sampleRate);
@@ -151,6 +163,9 @@ public:
         // Reset oscillators only on non-legato notes
         if (!isActive && !legato)
         {
+            if (params.oversampling != oversampler.getFactor())
+                configureOversampling(params.oversampling);
+
             osc1.reset();
             osc2.reset();
             wavetableOsc1.reset();
@@ -170,6 +185,9 @@ public:
         }
 
         isActive = true;
+        retiredEarly = false;
+        silentBlocks = 0;
+        retireFadeRemaining = 0;
 
         // Set velocity in mod matrix
         modMatrix.setSourceValue(Modulation::ModSource::Velocity, velocity);
@@ -188,6 +206,17 @@ public:
         modEnv.noteOff();
     }
 
+    // Render-path topology: one compiled kernel per combination of active stages
+    enum Topology : unsigned
+    {
+        TopologyOsc1      = 1u << 0,
+        TopologyOsc2      = 1u << 1,
+        TopologyNoise     = 1u << 2,
+        TopologyFilter    = 1u << 3,
+        TopologyStereoPan = 1u << 4,
+        NUM_TOPOLOGIES    = 1u << 5
+    };
+
     void process(float& left, float& right)
     {
         if (!isActive)
@@ -197,6 +226,281 @@ public:
             return;
         }
 
+        const unsigned topology = beginBlock();
+        std::array<float, DSP::Oversampler::MAX_FACTOR> noiseSamples{};
+
+        if (topology & TopologyNoise)
+            noise.fillBlock(noiseSamples.data(), oversampler.getFactor(), params.noiseLevel * noiseGainCompensation);
+
+        (this->*getRenderKernel(topology))(&left, &right, 1, noiseSamples.data());
+    }
+
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        const int factor = oversampler.getFactor();
+
+        // Topology is chosen once per chunk; noise is filled a chunk at a time
+        // so the generator runs vectorised
+        for (int start = 0; start < numSamples; start += NOISE_CHUNK)
+        {
+            const int n = std::min(NOISE_CHUNK, numSamples - start);
+
+            if (!isActive)
+            {
+                std::fill(left + start, left + numSamples, 0.0f);
+                std::fill(right + start, right + numSamples, 0.0f);
+                return;
+            }
+
+            const unsigned topology = beginBlock();
+
+            if (topology & TopologyNoise)
+                noise.fillBlock(noiseBuffer.data(), n * factor, params.noiseLevel * noiseGainCompensation);
+
+            (this->*getRenderKernel(topology))(left + start, right + start, n, noiseBuffer.data());
+
+            if (isActive)
+                updateSilenceTracking(left + start, right + start, n);
+        }
+    }
+
+    // Retire the voice after `numBlocks` consecutive blocks peaking below thresholdDb
+    void setSilenceThreshold(float thresholdDb, int numBlocks)
+    {
+        silenceThreshold = juce::Decibels::decibelsToGain(thresholdDb, -200.0f);
+        silenceBlocksToRetire = std::max(1, numBlocks);
+    }
+
+    // True if the voice was freed by the silence detector rather than its envelope
+    bool wasRetiredEarly() const { return retiredEarly; }
+
+    unsigned getTopology() const { return currentTopology; }
+
+    int getOversamplingFactor() const { return oversampler.getFactor(); }
+
+    bool isVoiceActive() const { return isActive; }
+    int getMidiNote() const { return midiNote; }
+    float getVelocity() const { return velocity; }
+
+    void setParameters(const Parameters& p)
+    {
+        params = p;
+        noise.setColour(params.noiseColour);
+        noiseGainCompensation = DSP::NoiseGenerator::getDecimationGain(params.noiseColour, oversampler.getFactor());
+        updateEnvelopes();
+    }
+
+    Parameters& getParameters() { return params; }
+    Modulation::ModMatrix& getModMatrix() { return modMatrix; }
+
+    // Seed every random source in the voice (noise, noise oscillators, S&H LFOs)
+    void setNoiseSeed(uint32_t seed)
+    {
+        noise.setSeed(seed);
+        osc1.setNoiseSeed(seed * 4u + 1u);
+        osc2.setNoiseSeed(seed * 4u + 2u);
+        lfo1.setSeed(seed * 4u + 3u);
+        lfo2.setSeed(seed * 4u + 4u);
+    }
+
+    void setLFOParams(DSP::LFO::Waveform lfo1Wave, float lfo1Rate,
+                      DSP::LFO::Waveform lfo2Wave, float lfo2Rate)
+    {
+        lfo1.setWaveform(lfo1Wave);
+        lfo1.setRate(lfo1Rate);
+        lfo2.setWaveform(lfo2Wave);
+        lfo2.setRate(lfo2Rate);
+    }
+
+    void reset()
+    {
+        isActive = false;
+        silentBlocks = 0;
+        retireFadeRemaining = 0;
+        osc1.reset();
+        osc2.reset();
+        wavetableOsc1.reset();
+        wavetableOsc2.reset();
+        filter.reset();
+        ampEnv.reset();
+        filterEnv.reset();
+        modEnv.reset();
+        lfo1.reset();
+        lfo2.reset();
+        modMatrix.reset();
+    }
+
+private:
+    using RenderKernel = void (SynthVoice::*)(float*, float*, int, const float*);
+
+    template <unsigned... Topologies>
+    static constexpr std::array<RenderKernel, sizeof...(Topologies)>
+    makeRenderKernels(std::integer_sequence<unsigned, Topologies...>)
+    {
+        return {{ &SynthVoice::renderBlock<Topologies>... }};
+    }
+
+    static RenderKernel getRenderKernel(unsigned topology)
+    {
+        static constexpr auto kernels = makeRenderKernels(std::make_integer_sequence<unsigned, NUM_TOPOLOGIES>{});
+        return kernels[topology];
+    }
+
+    // Only voices heading to silence may retire: released, or decaying to an inaudible sustain
+    bool canRetireEarly() const
+    {
+        switch (ampEnv.getState())
+        {
+            case DSP::ADSR::State::Release:
+                return true;
+
+            case DSP::ADSR::State::Decay:
+            case DSP::ADSR::State::Sustain:
+                return params.ampSustain * velocity * params.masterLevel < silenceThreshold;
+
+            default:
+                return false;
+        }
+    }
+
+    // Peak-track the rendered block; after enough silent blocks, fade out and free the voice
+    void updateSilenceTracking(float* left, float* right, int numSamples)
+    {
+        if (retireFadeRemaining > 0)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (retireFadeRemaining == 0)
+                {
+                    left[i] = 0.0f;
+                    right[i] = 0.0f;
+                    continue;
+                }
+
+                float fadeGain = static_cast<float>(--retireFadeRemaining) / RETIRE_FADE_SAMPLES;
+                left[i] *= fadeGain;
+                right[i] *= fadeGain;
+            }
+
+            if (retireFadeRemaining == 0)
+            {
+                isActive = false;
+                retiredEarly = true;
+                ampEnv.reset();
+                filterEnv.reset();
+                modEnv.reset();
+            }
+            return;
+        }
+
+        if (!canRetireEarly())
+        {
+            silentBlocks = 0;
+            return;
+        }
+
+        float peak = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+            peak = std::max(peak, std::max(std::abs(left[i]), std::abs(right[i])));
+
+        if (peak >= silenceThreshold)
+            silentBlocks = 0;
+        else if (++silentBlocks >= silenceBlocksToRetire)
+            retireFadeRemaining = RETIRE_FADE_SAMPLES;
+    }
+
+    // True unless the filter is a fully open, unmodulated low-pass
+    bool isFilterActive() const
+    {
+        if (params.filterType != DSP::SVFFilter::Type::LowPass
+            || params.filterResonance > 0.0f
+            || params.filterEnvAmount != 0.0f
+            || modMatrix.hasRoutingTo(Modulation::ModDest::FilterCutoff))
+            return true;
+
+        float staticCutoff = params.filterCutoff + params.filterKeyTrack * (midiNote - 60) * 100.0f;
+        return staticCutoff < 20000.0f;
+    }
+
+    // Resolve the topology and hoist everything that is constant for the block
+    unsigned beginBlock()
+    {
+        unsigned topology = 0;
+
+        if (params.osc1Enabled)
+        {
+            topology |= TopologyOsc1;
+            osc1.setWaveform(params.osc1Wave);
+            osc1.setPulseWidth(params.osc1PulseWidth);
+            osc1Ratio = std::pow(2.0f, params.osc1Octave + params.osc1Semi / 12.0f + params.osc1Fine / 1200.0f);
+        }
+
+        if (params.osc2Enabled)
+        {
+            topology |= TopologyOsc2;
+            osc2.setWaveform(params.osc2Wave);
+            osc2.setPulseWidth(params.osc2PulseWidth);
+            osc2Ratio = std::pow(2.0f, params.osc2Octave + params.osc2Semi / 12.0f + params.osc2Fine / 1200.0f);
+        }
+
+        if (params.noiseLevel > 0.0f)
+            topology |= TopologyNoise;
+
+        if (isFilterActive())
+        {
+            topology |= TopologyFilter;
+            filter.setResonance(params.filterResonance);
+            filter.setType(params.filterType);
+
+            // Coming out of bypass: don't resume from stale integrator state
+            if (!(currentTopology & TopologyFilter))
+                filter.reset();
+        }
+
+        const float halfPiOver2 = juce::MathConstants<float>::pi * 0.25f;
+        pan1L = std::cos((params.osc1Pan + 1.0f) * halfPiOver2);
+        pan1R = std::sin((params.osc1Pan + 1.0f) * halfPiOver2);
+        pan2L = std::cos((params.osc2Pan + 1.0f) * halfPiOver2);
+        pan2R = std::sin((params.osc2Pan + 1.0f) * halfPiOver2);
+
+        // Pan blending is only needed when osc 2 and (osc 1 or noise) sit at different positions
+        const bool hasLeftSource = (topology & (TopologyOsc1 | TopologyNoise)) != 0;
+        if ((topology & TopologyOsc2) && hasLeftSource && params.osc1Pan != params.osc2Pan)
+        {
+            topology |= TopologyStereoPan;
+        }
+        else if ((topology & TopologyOsc2) && !hasLeftSource)
+        {
+            pan1L = pan2L;
+            pan1R = pan2R;
+        }
+
+        currentTopology = topology;
+        return topology;
+    }
+
+    template <unsigned T>
+    void renderBlock(float* left, float* right, int numSamples, const float* noiseSamples)
+    {
+        const int factor = oversampler.getFactor();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (!isActive)
+            {
+                std::fill(left + i, left + numSamples, 0.0f);
+                std::fill(right + i, right + numSamples, 0.0f);
+                return;
+            }
+
+            renderSample<T>(left[i], right[i], noiseSamples + i * factor);
+        }
+    }
+
+    // noiseSamples holds one value per oversampled sub-step (read only when T has noise)
+    template <unsigned T>
+    void renderSample(float& left, float& right, const float* noiseSamples)
+    {
         // Update glide (exponential for natural pitch perception)
         if (currentFreq != glideTarget && glideRatio != 1.0f)
         {
@@ -226,57 +530,68 @@ public:
 
         modMatrix.process();
 
-        // Get modulated values
-        float pitchMod = modMatrix.getDestinationValue(Modulation::ModDest::Osc1Pitch);
-        float cutoffMod = modMatrix.getDestinationValue(Modulation::ModDest::FilterCutoff);
-
-        // Calculate modulated frequency
-        float modFreq = currentFreq * std::pow(2.0f, pitchMod / 12.0f);
+        // Configure oscillators (frequency is held across oversampled sub-steps)
+        if constexpr ((T & (TopologyOsc1 | TopologyOsc2)) != 0)
+        {
+            float pitchMod = modMatrix.getDestinationValue(Modulation::ModDest::Osc1Pitch);
+            float modFreq = currentFreq * std::pow(2.0f, pitchMod / 12.0f);
 
-        // Generate oscillators
-        float osc1Sample = 0.0f;
-        float osc2Sample = 0.0f;
+            if constexpr ((T & TopologyOsc1) != 0)
+                osc1.setFrequency(modFreq * osc1Ratio);
 
-        if (params.osc1Enabled)
-        {
-            float osc1Freq = modFreq * std::pow(2.0f, params.osc1Octave + params.osc1Semi / 12.0f + params.osc1Fine / 1200.0f);
-            osc1.setFrequency(osc1Freq);
-            osc1.setWaveform(params.osc1Wave);
-            osc1.setPulseWidth(params.osc1PulseWidth);
-            osc1Sample = osc1.process() * params.osc1Level;
+            if constexpr ((T & TopologyOsc2) != 0)
+                osc2.setFrequency(modFreq * osc2Ratio);
         }
 
-        if (params.osc2Enabled)
+        // Filter
+        if constexpr ((T & TopologyFilter) != 0)
         {
-            float osc2Freq = modFreq * std::pow(2.0f, params.osc2Octave + params.osc2Semi / 12.0f + params.osc2Fine / 1200.0f);
-            osc2.setFrequency(osc2Freq);
-            osc2.setWaveform(params.osc2Wave);
-            osc2.setPulseWidth(params.osc2PulseWidth);
-            osc2Sample = osc2.process() * params.osc2Level;
+            float cutoffMod = modMatrix.getDestinationValue(Modulation::ModDest::FilterCutoff);
+
+            float filterCutoff = params.filterCutoff;
+            filterCutoff += params.filterEnvAmount * filterEnvValue * 10000.0f;
+            filterCutoff += params.filterKeyTrack * (midiNote - 60) * 100.0f;
+            filterCutoff += cutoffMod * 5000.0f;
+            filterCutoff = juce::jlimit(20.0f, 20000.0f, filterCutoff);
+
+            filter.setCutoff(filterCutoff);
         }
 
-        // Noise
-        float noiseSample = 0.0f;
-        if (params.noiseLevel > 0.0f)
+        // Generate, mix (mono) and filter at the oversampled rate, then decimate.
+        // Pan weights accumulate |osc| over the sub-steps.
+        const int factor = oversampler.getFactor();
+        std::array<float, DSP::Oversampler::MAX_FACTOR> filtered{};
+        float osc1Weight = 0.0f;
+        float osc2Weight = 0.0f;
+
+        for (int k = 0; k < factor; ++k)
         {
-            noiseSample = (random.nextFloat() * 2.0f - 1.0f) * params.noiseLevel;
-        }
+            float osc1Sample = 0.0f;
+            float osc2Sample = 0.0f;
+            float noiseSample = 0.0f;
 
-        // Mix oscillators and filter (mono)
-        float mix = osc1Sample + osc2Sample + noiseSample;
+            if constexpr ((T & TopologyOsc1) != 0)
+                osc1Sample = osc1.process() * params.osc1Level;
+            if constexpr ((T & TopologyOsc2) != 0)
+                osc2Sample = osc2.process() * params.osc2Level;
+            if constexpr ((T & TopologyNoise) != 0)
+                noiseSample = noiseSamples[k];
 
-        // Filter
-        float filterCutoff = params.filterCutoff;
-        filterCutoff += params.filterEnvAmount * filterEnvValue * 10000.0f;
-        filterCutoff += params.filterKeyTrack * (midiNote - 60) * 100.0f;
-        filterCutoff += cutoffMod * 5000.0f;
-        filterCutoff = juce::jlimit(20.0f, 20000.0f, filterCutoff);
+            float mixed = osc1Sample + osc2Sample + noiseSample;
 
-        filter.setCutoff(filterCutoff);
-        filter.setResonance(params.filterResonance);
-        filter.setType(params.filterType);
+            if constexpr ((T & TopologyFilter) != 0)
+                mixed = filter.process(mixed);
 
-        mix = filter.process(mix);
+            filtered[static_cast<size_t>(k)] = mixed;
+
+            if constexpr ((T & TopologyStereoPan) != 0)
+            {
+                osc1Weight += std::abs(osc1Sample + noiseSample);
+                osc2Weight += std::abs(osc2Sample);
+            }
+        }
+
+        float mix = oversampler.process(filtered.data());
 
         // Apply amp envelope and master level
         float gain = ampEnvValue * velocity * params.masterLevel;
@@ -291,81 +606,43 @@ public:
         }
 
         // Per-oscillator stereo panning (equal-power)
-        // Scale each osc's contribution from the filtered mix by its relative level
-        float osc1Contrib = (osc1Sample + noiseSample) * gain;
-        float osc2Contrib = osc2Sample * gain;
-
-        float pan1L = std::cos((params.osc1Pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-        float pan1R = std::sin((params.osc1Pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-        float pan2L = std::cos((params.osc2Pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-        float pan2R = std::sin((params.osc2Pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-
-        // When both pans are center (0), this equals the original mono behavior
-        // When pans differ, oscillators spread in the stereo field
-        float totalAmp = std::abs(osc1Sample + noiseSample) + std::abs(osc2Sample);
-        if (totalAmp > 0.0001f)
-        {
-            float w1 = std::abs(osc1Sample + noiseSample) / totalAmp;
-            float w2 = std::abs(osc2Sample) / totalAmp;
-            float blendedPanL = pan1L * w1 + pan2L * w2;
-            float blendedPanR = pan1R * w1 + pan2R * w2;
-            left  = mix * gain * blendedPanL;
-            right = mix * gain * blendedPanR;
-        }
-        else
-        {
-            left  = mix * gain * pan1L;
-            right = mix * gain * pan1R;
-        }
-    }
-
-    void processBlock(float* left, float* right, int numSamples)
-    {
-        for (int i = 0; i < numSamples; ++i)
+        // When both sources share a pan position the blend collapses to a constant gain
+        if constexpr ((T & TopologyStereoPan) != 0)
         {
-            process(left[i], right[i]);
+            float totalAmp = osc1Weight + osc2Weight;
+            if (totalAmp > 0.0001f * factor)
+            {
+                float w1 = osc1Weight / totalAmp;
+                float w2 = osc2Weight / totalAmp;
+                float blendedPanL = pan1L * w1 + pan2L * w2;
+                float blendedPanR = pan1R * w1 + pan2R * w2;
+                left  = mix * gain * blendedPanL;
+                right = mix * gain * blendedPanR;
+                return;
+            }
         }
-    }
-
-    bool isVoiceActive() const { return isActive; }
-    int getMidiNote() const { return midiNote; }
-    float getVelocity() const { return velocity; }
-
-    void setParameters(const Parameters& p)
-    {
-        params = p;
-        updateEnvelopes();
-    }
 
-    Parameters& getParameters() { return params; }
-    Modulation::ModMatrix& getModMatrix() { return modMatrix; }
-
-    void setLFOParams(DSP::LFO::Waveform lfo1Wave, float lfo1Rate,
-                      DSP::LFO::Waveform lfo2Wave, float lfo2Rate)
-    {
-        lfo1.setWaveform(lfo1Wave);
-        lfo1.setRate(lfo1Rate);
-        lfo2.setWaveform(lfo2Wave);
-        lfo2.setRate(lfo2Rate);
+        left  = mix * gain * pan1L;
+        right = mix * gain * pan1R;
     }
 
-    void reset()
+    void configureOversampling(int factor)
     {
-        isActive = false;
-        osc1.reset();
-        osc2.reset();
-        wavetableOsc1.reset();
-        wavetableOsc2.reset();
-        filter.reset();
-        ampEnv.reset();
-        filterEnv.reset();
-        modEnv.reset();
-        lfo1.reset();
-        lfo2.reset();
-        modMatrix.reset();
+        oversampler.setFactor(factor);
+        factor = oversampler.getFactor();
+
+        const double osRate = sampleRate * factor;
+        osc1.prepare(osRate, samplesPerBlock);
+        osc2.prepare(osRate, samplesPerBlock);
+        filter.prepare(osRate, samplesPerBlock);
+
+        // Decimation keeps only the host band of the noise; how much that is depends on its colour
+        noiseGainCompensation = DSP::NoiseGenerator::getDecimationGain(params.noiseColour, factor);
+        const float oscNoiseGain = DSP::NoiseGenerator::getDecimationGain(DSP::NoiseGenerator::Colour::White, factor);
+        osc1.setNoiseGain(oscNoiseGain);
+        osc2.setNoiseGain(oscNoiseGain);
     }
 
-private:
     float midiNoteToFrequency(int note) const
     {
         return 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
@@ -399,6 +676,7 @@ private:
     }
 
     double sampleRate = 44100.0;
+    int samplesPerBlock = 512;
 
     // State
     bool isActive = false;
@@ -415,6 +693,24 @@ private:
     // Filter
     DSP::SVFFilter filter;
 
+    // Per-block constants hoisted out of the render kernels
+    unsigned currentTopology = 0;
+    float osc1Ratio = 1.0f;
+    float osc2Ratio = 1.0f;
+    float pan1L = 0.7071f, pan1R = 0.7071f;
+    float pan2L = 0.7071f, pan2R = 0.7071f;
+
+    // Silence detection (early retirement); default -96 dBFS over 8 blocks
+    float silenceThreshold = 1.5849e-5f;
+    int silenceBlocksToRetire = 8;
+    int silentBlocks = 0;
+    int retireFadeRemaining = 0;
+    bool retiredEarly = false;
+
+    // Oversampling around oscillators + filter
+    DSP::Oversampler oversampler;
+    float noiseGainCompensation = 1.0f;
+
     // Envelopes
     DSP::ADSR ampEnv, filterEnv, modEnv;
 
@@ -425,7 +721,8 @@ private:
     Modulation::ModMatrix modMatrix;
 
     // Noise
-    juce::Random random;
+    DSP::NoiseGenerator noise;
+    std::array<float, NOISE_CHUNK * DSP::Oversampler::MAX_FACTOR> noiseBuffer{};
 
     // Parameters
     Parameters params;
@@ -5,6 +5,7 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <atomic>
 
 namespace NulyBeats {
 namespace Engine {
@@ -18,6 +19,9 @@ public:
     static constexpr int MAX_VOICES = 64;
     static constexpr int MAX_UNISON = 8;
 
+    // Internal render block size, independent of the host block size
+    static constexpr int RENDER_QUANTUM = 32;
+
     enum class VoiceStealingMode
     {
         Oldest,
@@ -36,6 +40,10 @@ public:
     VoiceManager()
     {
         voices.resize(MAX_VOICES);
+
+        // Distinct, fixed noise seeds per voice so renders are repeatable
+        for (size_t i = 0; i < voices.size(); ++i)
+            voices[i].setNoiseSeed(static_cast<uint32_t>(i + 1));
     }
 
     void prepare(double sampleRate, int samplesPerBlock)
@@ -43,12 +51,9 @@ public:
         this->sampleRate = sampleRate;
         this->samplesPerBlock = samplesPerBlock;
 
-        // Pre-allocate voice buffers to avoid real-time allocation
-        voiceBufferLeft.resize(static_cast<size_t>(samplesPerBlock));
-        voiceBufferRight.resize(static_cast<size_t>(samplesPerBlock));
-
+        // Voices only ever see quantum-sized blocks, whatever the host sends
         for (auto& voice : voices)
-            voice.prepare(sampleRate, samplesPerBlock);
+            voice.prepare(sampleRate, RENDER_QUANTUM);
     }
 
     void setPolyphony(int numVoices)
@@ -80,6 +85,13 @@ public:
         velocityCurve = curve;
     }
 
+    // Voices peaking below thresholdDb for numQuanta consecutive quanta are retired
+    void setSilenceThreshold(float thresholdDb, int numQuanta)
+    {
+        for (auto& voice : voices)
+            voice.setSilenceThreshold(thresholdDb, numQuanta);
+    }
+
     void setLFOParams(DSP::LFO::Waveform lfo1Wave, float lfo1Rate,
                       DSP::LFO::Waveform lfo2Wave, float lfo2Rate)
     {
@@ -87,6 +99,13 @@ public:
             voice.setLFOParams(lfo1Wave, lfo1Rate, lfo2Wave, lfo2Rate);
     }
 
+    // Plugin-wide sources the voices can't read from MIDI (the macro knobs)
+    void setGlobalSourceValue(Modulation::ModSource source, float value)
+    {
+        for (auto& voice : voices)
+            voice.getModMatrix().setSourceValue(source, value);
+    }
+
     // Rebuild every voice's mod matrix using the provided callback
     void rebuildModMatrix(const std::function<void(SynthVoice&)>& buildFn)
     {
@@ -303,6 +322,15 @@ public:
     }
 
     void processBlock(juce::AudioBuffer<float>& buffer, bool clearBuffer = true)
+    {
+        processBlock(buffer, juce::MidiBuffer(), clearBuffer);
+    }
+
+    // Render the host block in fixed RENDER_QUANTUM slices. MIDI events are
+    // applied at the start of the quantum they fall in, so the host block size
+    // never reaches the voices and per-voice buffers stay L1-sized.
+    void processBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages,
+                      bool clearBuffer = true)
     {
         if (clearBuffer)
             buffer.clear();
@@ -311,25 +339,21 @@ public:
         float* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : left;
 
         const int numSamples = buffer.getNumSamples();
+        auto nextEvent = midiMessages.begin();
 
-        // Use pre-allocated buffers (no real-time allocation)
-        for (auto& voice : voices)
+        for (int start = 0; start < numSamples; start += RENDER_QUANTUM)
         {
-            if (voice.isVoiceActive())
-            {
-                std::fill(voiceBufferLeft.begin(), voiceBufferLeft.begin() + numSamples, 0.0f);
-                std::fill(voiceBufferRight.begin(), voiceBufferRight.begin() + numSamples, 0.0f);
+            const int n = std::min(RENDER_QUANTUM, numSamples - start);
 
-                voice.processBlock(voiceBufferLeft.data(), voiceBufferRight.data(), numSamples);
+            for (; nextEvent != midiMessages.end() && (*nextEvent).samplePosition < start + n; ++nextEvent)
+                handleMidiMessage((*nextEvent).getMessage());
 
-                // Sum into output
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    left[i] += voiceBufferLeft[static_cast<size_t>(i)];
-                    right[i] += voiceBufferRight[static_cast<size_t>(i)];
-                }
-            }
+            renderQuantum(left + start, right + start, n);
         }
+
+        // Events stamped past the end of the block still get applied
+        for (; nextEvent != midiMessages.end(); ++nextEvent)
+            handleMidiMessage((*nextEvent).getMessage());
     }
 
     void handleMidiMessage(const juce::MidiMessage& msg)
@@ -412,6 +436,9 @@ public:
         }
     }
 
+    // Telemetry: total voices freed by the silence detector (safe from any thread)
+    uint32_t getRetiredVoiceCount() const { return retiredVoiceCount.load(std::memory_order_relaxed); }
+
     int getActiveVoiceCount() const
     {
         int count = 0;
@@ -434,6 +461,24 @@ public:
     }
 
 private:
+    void renderQuantum(float* left, float* right, int numSamples)
+    {
+        for (auto& voice : voices)
+        {
+            if (voice.isVoiceActive())
+            {
+                // The voice writes every sample, zero-filling after it finishes
+                voice.processBlock(voiceBufferLeft.data(), voiceBufferRight.data(), numSamples);
+
+                juce::FloatVectorOperations::add(left, voiceBufferLeft.data(), numSamples);
+                juce::FloatVectorOperations::add(right, voiceBufferRight.data(), numSamples);
+
+                if (!voice.isVoiceActive() && voice.wasRetiredEarly())
+                    retiredVoiceCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
     SynthVoice* findFreeVoice()
     {
         for (int i = 0; i < maxPolyphony * unisonVoices; ++i)
@@ -514,9 +559,9 @@ private:
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
 
-    // Pre-allocated voice mixing buffers (avoids real-time allocation)
-    std::vector<float> voiceBufferLeft;
-    std::vector<float> voiceBufferRight;
+    // Per-quantum voice mixing buffers (fixed size, L1-resident)
+    alignas(32) std::array<float, RENDER_QUANTUM> voiceBufferLeft{};
+    alignas(32) std::array<float, RENDER_QUANTUM> voiceBufferRight{};
 
     std::vector<SynthVoice> voices;
     SynthVoice::Parameters voiceParams;
@@ -539,6 +584,8 @@ private:
 
     // Velocity curve: 1.0 = linear, < 1.0 = soft, > 1.0 = hard
     float velocityCurve = 1.0f;
+
+    std::atomic<uint32_t> retiredVoiceCount{0};
 };
 
 } // namespace Engine
@@ -15,6 +15,11 @@ public:
         sourceCombo.addItem("Env 2",     5);
         sourceCombo.addItem("Velocity",  6);
         sourceCombo.addItem("Mod Wheel", 7);
+        sourceCombo.addItem("Aftertouch", 8);
+        sourceCombo.addItem("Boost",     9);
+        sourceCombo.addItem("Air",       10);
+        sourceCombo.addItem("Body",      11);
+        sourceCombo.addItem("Warp",      12);
         sourceCombo.setSelectedId(1, juce::dontSendNotification);
         sourceCombo.onChange = [this]() { notifyParent(); };
         addAndMakeVisible(sourceCombo);
@@ -26,6 +31,12 @@ public:
         destCombo.addItem("Osc Level",        5);
         destCombo.addItem("Amp Pan",          6);
         destCombo.addItem("Amp Level",        7);
+        destCombo.addItem("Reverb Mix",       8);
+        destCombo.addItem("Delay Mix",        9);
+        destCombo.addItem("Delay Time",       10);
+        destCombo.addItem("Chorus Mix",       11);
+        destCombo.addItem("Chorus Rate",      12);
+        destCombo.addItem("FX Mix",           13);
         destCombo.setSelectedId(1, juce::dontSendNotification);
         destCombo.onChange = [this]() { notifyParent(); };
         addAndMakeVisible(destCombo);
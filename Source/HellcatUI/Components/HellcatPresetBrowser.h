@@ -18,12 +18,16 @@ public:
         addAndMakeVisible(listBox);
     }
 
-    void setCategories(const std::vector<juce::String>& cats)
+    // Selects `keepSelected` if it is still listed, otherwise the first category
+    void setCategories(const std::vector<juce::String>& cats, const juce::String& keepSelected = {})
     {
         categories = cats;
         listBox.updateContent();
         if (!categories.empty())
-            listBox.selectRow(0);
+        {
+            auto it = std::find(categories.begin(), categories.end(), keepSelected);
+            listBox.selectRow(it != categories.end() ? static_cast<int>(it - categories.begin()) : 0);
+        }
     }
 
     int getNumRows() override { return static_cast<int>(categories.size()); }
@@ -336,6 +340,14 @@ public:
         categoryList.setCategories(categories);
     }
 
+    // After the library changed on disk: keeps the current category selected
+    void refreshCategories(const std::vector<juce::String>& categories)
+    {
+        categoryList.setCategories(categories, currentCategory);
+    }
+
+    const juce::String& getCurrentCategory() const { return currentCategory; }
+
     void setPresetsForCategory(const std::vector<HellcatPresetList::PresetInfo>& presets)
     {
         allPresets = presets;
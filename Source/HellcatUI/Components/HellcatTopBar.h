@@ -206,6 +206,16 @@ public:
 
         // Output meter
         drawOutputMeter(g, meterBounds);
+
+        // Sample preset load progress, under the preset name
+        if (loadProgress >= 0.0f)
+        {
+            auto bar = getLoadProgressBounds().toFloat();
+            g.setColour(HellcatColors::panelLight);
+            g.fillRect(bar);
+            g.setColour(HellcatColors::hellcatRed);
+            g.fillRect(bar.withWidth(bar.getWidth() * loadProgress));
+        }
     }
 
     void resized() override
@@ -302,6 +312,16 @@ public:
     juce::Slider& getVelCurveSlider()     { return velCurveSlider; }
     juce::Slider& getPitchBendSlider()    { return pitchBendSlider; }
 
+    /** Sample preset load progress (0.0 - 1.0); negative hides the bar */
+    void setLoadProgress(float progress)
+    {
+        if (progress == loadProgress)
+            return;
+
+        loadProgress = progress;
+        repaint(getLoadProgressBounds());
+    }
+
     /** Set the real RMS level from the audio processor (0.0 - 1.0) */
     void setRmsLevel(float rms)
     {
@@ -320,6 +340,11 @@ public:
     }
 
 private:
+    juce::Rectangle<int> getLoadProgressBounds() const
+    {
+        return presetButton.getBounds().withY(presetButton.getBottom() + 3).withHeight(2);
+    }
+
     void timerCallback() override
     {
         // Convert RMS (0.0-1.0) to meter bar count (0-10)
@@ -483,5 +508,6 @@ private:
     juce::Image logoImage;
     int meterLevel = 0;
     float currentRms = 0.0f;
+    float loadProgress = -1.0f;
     juce::Label accountLabel;
 };
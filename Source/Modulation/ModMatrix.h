@@ -264,6 +264,17 @@ public:
         }
     }
 
+    // True if any routing targets this destination (lets callers skip unmodulated stages)
+    bool hasRoutingTo(ModDest dest) const
+    {
+        for (int i = 0; i < numRoutings; ++i)
+        {
+            if (routings[i].destination == dest)
+                return true;
+        }
+        return false;
+    }
+
     // Get pre-calculated destination value
     float getDestinationValue(ModDest dest) const
     {
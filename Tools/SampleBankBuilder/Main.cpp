@@ -0,0 +1,89 @@
+#include <JuceHeader.h>
+#include "../../Source/Engine/PCM/SamplePresetManager.h"
+#include <iostream>
+
+using namespace NulyBeats::Engine;
+
+/**
+ * Packs Resources/Samples into one .nbbank per category
+ *
+ * Usage: SampleBankBuilder <resources dir> [output dir]
+ * The output directory defaults to <resources dir>/Samples, where the plugin
+ * picks banks up in place of the category folders.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: SampleBankBuilder <resources dir> [output dir]" << std::endl;
+        return 1;
+    }
+
+    const juce::File resourceDir = juce::File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+    const juce::File outputDir = argc > 2 ? juce::File::getCurrentWorkingDirectory().getChildFile(argv[2])
+                                          : resourceDir.getChildFile("Samples");
+
+    if (!outputDir.createDirectory())
+    {
+        std::cerr << "Cannot create " << outputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    SamplePresetManager manager;
+    manager.scanSampleDirectory(resourceDir, false);
+
+    if (manager.getCategories().empty())
+    {
+        std::cerr << "No sample categories under " << resourceDir.getChildFile("Samples").getFullPathName() << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+
+    for (const auto& category : manager.getCategories())
+    {
+        SampleBankWriter writer;
+        size_t numZones = 0;
+
+        for (const auto& preset : manager.getPresetsInCategory(category))
+        {
+            SampleBankWriter::PresetSource source;
+            source.name = preset.name;
+            source.rootNote = preset.rootNote;
+            source.multisampled = preset.isMultisampled;
+
+            if (preset.isMultisampled)
+            {
+                for (const auto& zone : preset.zones)
+                    source.zones.push_back({ zone.sampleFile, zone.rootNote, zone.lowKey, zone.highKey });
+            }
+            else
+            {
+                source.zones.push_back({ preset.sampleFile, preset.rootNote, 0, 127 });
+            }
+
+            numZones += source.zones.size();
+            writer.addPreset(std::move(source));
+        }
+
+        const auto bankFile = outputDir.getChildFile(category + SampleBankFormat::FILE_EXTENSION);
+        juce::StringArray errors;
+        const bool ok = writer.write(bankFile, &errors);
+
+        for (const auto& error : errors)
+            std::cerr << "  " << error << std::endl;
+
+        if (ok)
+        {
+            std::cout << category << ": " << numZones << " zones, "
+                      << (bankFile.getSize() / (1024 * 1024)) << " MB -> " << bankFile.getFullPathName() << std::endl;
+        }
+        else
+        {
+            std::cerr << category << ": failed to write " << bankFile.getFullPathName() << std::endl;
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}